@@ -0,0 +1,205 @@
+#include "quickjs_allocator.h"
+#include "quickjs_wrapper.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace QuickJSWrapper {
+
+namespace {
+    constexpr size_t kAlignment = 16;
+
+    size_t alignUp(size_t size) {
+        return (size + kAlignment - 1) & ~(kAlignment - 1);
+    }
+}
+
+// Allocator implementation
+void* Allocator::reallocate(void* ptr, size_t oldSize, size_t newSize) {
+    void* fresh = allocate(newSize);
+    if (fresh) {
+        std::memcpy(fresh, ptr, std::min(oldSize, newSize));
+        deallocate(ptr, oldSize);
+    }
+    return fresh;
+}
+
+// MallocAllocator implementation
+void* MallocAllocator::allocate(size_t size) {
+    return std::malloc(size);
+}
+
+void MallocAllocator::deallocate(void* ptr, size_t) {
+    std::free(ptr);
+}
+
+void* MallocAllocator::reallocate(void* ptr, size_t, size_t newSize) {
+    return std::realloc(ptr, newSize);
+}
+
+// PoolAllocator implementation
+PoolAllocator::PoolAllocator() {
+    std::fill(std::begin(freeLists_), std::end(freeLists_), nullptr);
+}
+
+PoolAllocator::~PoolAllocator() {
+    for (void* chunk : chunks_) {
+        std::free(chunk);
+    }
+}
+
+std::shared_ptr<PoolAllocator> PoolAllocator::forCurrentThread() {
+    thread_local std::shared_ptr<PoolAllocator> pool = std::make_shared<PoolAllocator>();
+    return pool;
+}
+
+void PoolAllocator::refill(size_t index) {
+    char* chunk = static_cast<char*>(std::malloc(kChunkSize));
+    if (!chunk) {
+        return;
+    }
+    chunks_.push_back(chunk);
+
+    // Thread the whole chunk onto the free list of this class
+    size_t blockSize = (index + 1) * kGranularity;
+    FreeBlock* head = freeLists_[index];
+    for (size_t offset = kChunkSize - kChunkSize % blockSize; offset >= blockSize; offset -= blockSize) {
+        auto* block = reinterpret_cast<FreeBlock*>(chunk + offset - blockSize);
+        block->next = head;
+        head = block;
+    }
+    freeLists_[index] = head;
+}
+
+void* PoolAllocator::allocate(size_t size) {
+    if (size == 0 || size > kMaxClassSize) {
+        return std::malloc(size ? size : 1);
+    }
+    size_t index = classIndex(size);
+    if (!freeLists_[index]) {
+        refill(index);
+        if (!freeLists_[index]) {
+            return nullptr;
+        }
+    }
+    FreeBlock* block = freeLists_[index];
+    freeLists_[index] = block->next;
+    return block;
+}
+
+void PoolAllocator::deallocate(void* ptr, size_t size) {
+    if (!ptr) {
+        return;
+    }
+    if (size == 0 || size > kMaxClassSize) {
+        std::free(ptr);
+        return;
+    }
+    size_t index = classIndex(size);
+    auto* block = static_cast<FreeBlock*>(ptr);
+    block->next = freeLists_[index];
+    freeLists_[index] = block;
+}
+
+void* PoolAllocator::reallocate(void* ptr, size_t oldSize, size_t newSize) {
+    bool oldPooled = oldSize > 0 && oldSize <= kMaxClassSize;
+    bool newPooled = newSize > 0 && newSize <= kMaxClassSize;
+    if (oldPooled && newPooled && classIndex(oldSize) == classIndex(newSize)) {
+        return ptr;
+    }
+    if (!oldPooled && !newPooled) {
+        return std::realloc(ptr, newSize);
+    }
+    return Allocator::reallocate(ptr, oldSize, newSize);
+}
+
+// ArenaAllocator implementation
+ArenaAllocator::ArenaAllocator(size_t chunkSize)
+    : chunkSize_(alignUp(std::max(chunkSize, kAlignment))) {
+}
+
+ArenaAllocator::~ArenaAllocator() {
+    for (const auto& chunk : chunks_) {
+        std::free(chunk.data);
+    }
+}
+
+void* ArenaAllocator::bump(size_t size) {
+    size = alignUp(std::max<size_t>(size, 1));
+    for (; current_ < chunks_.size(); ++current_) {
+        Chunk& chunk = chunks_[current_];
+        if (chunk.size - chunk.used >= size) {
+            void* ptr = chunk.data + chunk.used;
+            chunk.used += size;
+            return ptr;
+        }
+    }
+
+    // Oversized requests get a dedicated chunk
+    size_t chunkSize = std::max(chunkSize_, size);
+    char* data = static_cast<char*>(std::malloc(chunkSize));
+    if (!data) {
+        return nullptr;
+    }
+    chunks_.push_back(Chunk{data, chunkSize, size});
+    current_ = chunks_.size() - 1;
+    return data;
+}
+
+void* ArenaAllocator::allocate(size_t size) {
+    void* ptr = bump(size);
+    if (ptr) {
+        liveBlocks_++;
+        last_ = ptr;
+    }
+    return ptr;
+}
+
+void ArenaAllocator::deallocate(void* ptr, size_t) {
+    // Memory is reclaimed by reset(); only the live count changes
+    if (ptr) {
+        liveBlocks_--;
+    }
+}
+
+void* ArenaAllocator::reallocate(void* ptr, size_t oldSize, size_t newSize) {
+    if (ptr == last_ && current_ < chunks_.size()) {
+        Chunk& chunk = chunks_[current_];
+        size_t offset = static_cast<char*>(ptr) - chunk.data;
+        if (offset < chunk.size && offset + alignUp(newSize) <= chunk.size) {
+            chunk.used = offset + alignUp(newSize);
+            return ptr;
+        }
+    }
+    return Allocator::reallocate(ptr, oldSize, newSize);
+}
+
+void ArenaAllocator::reset() {
+    if (liveBlocks_ != 0) {
+        throw Exception("Failed to reset arena: " + std::to_string(liveBlocks_) + " blocks still live");
+    }
+    for (auto& chunk : chunks_) {
+        chunk.used = 0;
+    }
+    current_ = 0;
+    last_ = nullptr;
+}
+
+size_t ArenaAllocator::getUsedBytes() const {
+    size_t used = 0;
+    for (const auto& chunk : chunks_) {
+        used += chunk.used;
+    }
+    return used;
+}
+
+size_t ArenaAllocator::getReservedBytes() const {
+    size_t reserved = 0;
+    for (const auto& chunk : chunks_) {
+        reserved += chunk.size;
+    }
+    return reserved;
+}
+
+} // namespace QuickJSWrapper
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace QuickJSWrapper {
+
+// Memory policy for a Runtime, installed through JS_NewRuntime2. Every block
+// QuickJS allocates on that runtime, including the runtime itself, comes from
+// here. The runtime prefixes each block with a small header recording its
+// size, so deallocate and reallocate always receive the size that was
+// allocated. Returned pointers must be aligned to 16 bytes.
+//
+// A runtime is used from one thread at a time, so implementations only need
+// to be thread-safe if they are shared between runtimes on different threads.
+class Allocator {
+public:
+    virtual ~Allocator() = default;
+
+    virtual void* allocate(size_t size) = 0;
+    virtual void deallocate(void* ptr, size_t size) = 0;
+    // Default: allocate, copy and deallocate
+    virtual void* reallocate(void* ptr, size_t oldSize, size_t newSize);
+};
+
+// Plain malloc/realloc/free; the default when a runtime gets no allocator
+class MallocAllocator : public Allocator {
+public:
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr, size_t size) override;
+    void* reallocate(void* ptr, size_t oldSize, size_t newSize) override;
+};
+
+// Segregated free lists in 16-byte size classes, carved from large chunks;
+// blocks above the largest class go to malloc. Not thread-safe: use one pool
+// per thread, e.g. through forCurrentThread(). Chunks are returned to the
+// system when the pool is destroyed, which the runtimes holding it delay.
+class PoolAllocator : public Allocator {
+public:
+    static constexpr size_t kGranularity = 16;
+    static constexpr size_t kMaxClassSize = 1024;
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    PoolAllocator();
+    ~PoolAllocator() override;
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    // The calling thread's pool, created on first use
+    static std::shared_ptr<PoolAllocator> forCurrentThread();
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr, size_t size) override;
+    void* reallocate(void* ptr, size_t oldSize, size_t newSize) override;
+
+    // Bytes reserved from the system for size-class chunks
+    size_t getReservedBytes() const { return chunks_.size() * kChunkSize; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static constexpr size_t kClassCount = kMaxClassSize / kGranularity;
+
+    FreeBlock* freeLists_[kClassCount];
+    std::vector<void*> chunks_;
+
+    static size_t classIndex(size_t size) { return (size - 1) / kGranularity; }
+    void refill(size_t index);
+};
+
+// Bump allocator for request-scoped runtimes: frees are no-ops and all memory
+// is reclaimed at once by reset(), which keeps the chunks for the next
+// request. reset() requires every block to have been freed, i.e. every
+// runtime using the arena to have been destroyed. Not thread-safe.
+class ArenaAllocator : public Allocator {
+public:
+    static constexpr size_t kDefaultChunkSize = 256 * 1024;
+
+    explicit ArenaAllocator(size_t chunkSize = kDefaultChunkSize);
+    ~ArenaAllocator() override;
+
+    ArenaAllocator(const ArenaAllocator&) = delete;
+    ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr, size_t size) override;
+    // Grows the most recent allocation in place when possible
+    void* reallocate(void* ptr, size_t oldSize, size_t newSize) override;
+
+    // Throws Exception while blocks are still live
+    void reset();
+
+    size_t getUsedBytes() const;
+    size_t getReservedBytes() const;
+    size_t getLiveBlocks() const { return liveBlocks_; }
+
+private:
+    struct Chunk {
+        char* data;
+        size_t size;
+        size_t used;
+    };
+
+    size_t chunkSize_;
+    std::vector<Chunk> chunks_;
+    // Chunk currently bumped from; earlier chunks are full
+    size_t current_ = 0;
+    size_t liveBlocks_ = 0;
+    void* last_ = nullptr;
+
+    void* bump(size_t size);
+};
+
+} // namespace QuickJSWrapper
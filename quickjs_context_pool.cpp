@@ -0,0 +1,220 @@
+#include "quickjs_context_pool.h"
+#include <algorithm>
+#include <utility>
+
+namespace QuickJSWrapper {
+
+struct ContextPool::Entry {
+    std::shared_ptr<Runtime> runtime;
+    std::unique_ptr<Context> context;
+    // Leases since the runtime was created
+    size_t uses = 0;
+};
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Jobs a released context may still run before its runtime is given up
+    constexpr size_t kMaxDrainedJobs = 10000;
+
+    void recordLatency(std::chrono::nanoseconds elapsed,
+                       std::chrono::nanoseconds& total,
+                       std::chrono::nanoseconds& max) {
+        total += elapsed;
+        max = std::max(max, elapsed);
+    }
+
+    // Runs pending promise jobs; returns false if they keep coming
+    bool drainPendingJobs(JSRuntime* rt) {
+        for (size_t i = 0; i < kMaxDrainedJobs; ++i) {
+            JSContext* jobCtx = nullptr;
+            int result = JS_ExecutePendingJob(rt, &jobCtx);
+            if (result == 0) {
+                return true;
+            }
+            if (result < 0) {
+                JS_FreeValue(jobCtx, JS_GetException(jobCtx));
+            }
+        }
+        return !JS_IsJobPending(rt);
+    }
+}
+
+// Lease implementation
+ContextPool::Lease::Lease(ContextPool* pool, Entry* entry)
+    : pool_(pool), entry_(entry) {
+}
+
+ContextPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), entry_(other.entry_) {
+    other.entry_ = nullptr;
+}
+
+ContextPool::Lease& ContextPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        entry_ = other.entry_;
+        other.entry_ = nullptr;
+    }
+    return *this;
+}
+
+ContextPool::Lease::~Lease() {
+    release();
+}
+
+Context& ContextPool::Lease::context() const {
+    if (!entry_) {
+        throw Exception("Context lease has been released");
+    }
+    return *entry_->context;
+}
+
+void ContextPool::Lease::release() noexcept {
+    if (entry_) {
+        Entry* entry = entry_;
+        entry_ = nullptr;
+        pool_->release(entry);
+    }
+}
+
+// ContextPool implementation
+ContextPool::ContextPool(ContextPoolOptions options)
+    : options_(std::move(options)), owner_(std::this_thread::get_id()) {
+    entries_.reserve(options_.size);
+    idle_.reserve(options_.size);
+    for (size_t i = 0; i < options_.size; ++i) {
+        entries_.push_back(createEntry());
+        idle_.push_back(entries_.back().get());
+    }
+}
+
+ContextPool::~ContextPool() = default;
+
+std::unique_ptr<ContextPool::Entry> ContextPool::createEntry() {
+    auto entry = std::make_unique<Entry>();
+    entry->runtime = options_.runtime ? options_.runtime : std::make_shared<Runtime>();
+    entry->context = newContext(entry->runtime);
+    return entry;
+}
+
+std::unique_ptr<Context> ContextPool::newContext(const std::shared_ptr<Runtime>& runtime) {
+    auto context = std::make_unique<Context>(runtime);
+    if (options_.initializer) {
+        options_.initializer(*context);
+    }
+    return context;
+}
+
+bool ContextPool::recycle(Entry& entry) {
+    // The lease may be released on another thread than it was acquired on
+    if (!options_.runtime) {
+        entry.runtime->updateStackTop();
+    }
+    entry.context.reset();
+    // Jobs keep their context alive, so they still run in the discarded one.
+    // The job queue of a shared runtime also holds other leases' jobs, which
+    // are left to whoever drives that runtime.
+    bool settled = options_.runtime || drainPendingJobs(entry.runtime->getJSRuntime());
+
+    bool replaceRuntime = !options_.runtime &&
+        (!settled || (options_.maxUsesPerRuntime > 0 && entry.uses >= options_.maxUsesPerRuntime));
+    if (replaceRuntime) {
+        entry.runtime = std::make_shared<Runtime>();
+        entry.uses = 0;
+    } else if (options_.runGCOnRelease) {
+        entry.runtime->runGC();
+    }
+    entry.context = newContext(entry.runtime);
+    return replaceRuntime;
+}
+
+ContextPool::Lease ContextPool::acquire() {
+    if (options_.runtime && std::this_thread::get_id() != owner_) {
+        throw Exception("Failed to acquire context: a pool on a shared runtime is bound to the thread that created it");
+    }
+
+    auto start = Clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (idle_.empty() && !entries_.empty()) {
+        metrics_.waits++;
+        available_.wait(lock, [this]() { return !idle_.empty() || entries_.empty(); });
+    }
+    if (idle_.empty()) {
+        throw Exception("Failed to acquire context: every pooled context has been discarded");
+    }
+
+    Entry* entry = idle_.back();
+    idle_.pop_back();
+    entry->uses++;
+    metrics_.acquisitions++;
+    lock.unlock();
+
+    // The private runtime is ours until release, so its stack limit can be
+    // moved to this thread without further locking
+    if (!options_.runtime) {
+        entry->runtime->updateStackTop();
+    }
+
+    lock.lock();
+    recordLatency(Clock::now() - start, metrics_.totalAcquireTime, metrics_.maxAcquireTime);
+    return Lease(this, entry);
+}
+
+void ContextPool::release(Entry* entry) noexcept {
+    auto start = Clock::now();
+    bool recreated = false;
+    bool usable = true;
+    try {
+        recreated = recycle(*entry);
+    } catch (...) {
+        // Start over with a new entry, as if the pool were being built
+        try {
+            entry->context.reset();
+            auto fresh = createEntry();
+            entry->runtime = std::move(fresh->runtime);
+            entry->context = std::move(fresh->context);
+            entry->uses = 0;
+            recreated = true;
+        } catch (...) {
+            usable = false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_.releases++;
+    if (!usable) {
+        // The pool shrinks; waiters are woken so they fail instead of
+        // blocking forever once no entry is left
+        auto found = std::find_if(entries_.begin(), entries_.end(),
+                                  [entry](const std::unique_ptr<Entry>& e) { return e.get() == entry; });
+        entries_.erase(found);
+        metrics_.discarded++;
+        available_.notify_all();
+        return;
+    }
+    idle_.push_back(entry);
+    if (recreated) {
+        metrics_.recreations++;
+    }
+    recordLatency(Clock::now() - start, metrics_.totalReleaseTime, metrics_.maxReleaseTime);
+    available_.notify_one();
+}
+
+size_t ContextPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t ContextPool::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+}
+
+ContextPoolMetrics ContextPool::getMetrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metrics_;
+}
+
+} // namespace QuickJSWrapper
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "quickjs_wrapper.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace QuickJSWrapper {
+
+struct ContextPoolOptions {
+    // Number of contexts created up front
+    size_t size = 4;
+    // Runs on every new context, e.g. to bind host functions or evaluate
+    // bootstrap code
+    std::function<void(Context&)> initializer;
+    // Run the garbage collector when a context is returned
+    bool runGCOnRelease = false;
+    // Replace a pooled context's private runtime after this many leases
+    // (0 = never), bounding the growth of its atom table and heap. Ignored
+    // with a shared runtime.
+    size_t maxUsesPerRuntime = 0;
+    // Optional runtime shared by all pooled contexts. A runtime is used by one
+    // thread at a time, so leases must then be acquired and used on the
+    // thread that created the pool. Without it every context gets its own
+    // runtime and leases may be acquired on any thread.
+    std::shared_ptr<Runtime> runtime;
+};
+
+struct ContextPoolMetrics {
+    size_t acquisitions = 0;
+    size_t releases = 0;
+    size_t waits = 0;
+    // Private runtimes replaced, after maxUsesPerRuntime leases or because
+    // a request left promise jobs that would not settle
+    size_t recreations = 0;
+    // Entries dropped because no context could be created for them
+    size_t discarded = 0;
+    std::chrono::nanoseconds totalAcquireTime{0};
+    std::chrono::nanoseconds maxAcquireTime{0};
+    std::chrono::nanoseconds totalReleaseTime{0};
+    std::chrono::nanoseconds maxReleaseTime{0};
+};
+
+// Pre-warmed contexts handed out one per request. On release the context is
+// discarded and a new one is created and initialized on the same runtime, so
+// nothing a request did (globals, top-level let/const, changed built-ins,
+// pending exceptions) reaches the next lease, and acquire() never pays for
+// initialization. Against a fresh Context per request this saves only the
+// runtime setup: context creation and the initializer still run once per
+// lease, on the release path. With private runtimes, promise jobs the
+// request left pending are run to completion in the discarded context
+// first; on a shared runtime they stay queued for the runtime's owner to
+// run, since the queue also holds the jobs of other live leases.
+class ContextPool {
+private:
+    struct Entry;
+
+public:
+    // Exclusive use of one pooled context; returns it to the pool on
+    // destruction. The context's stack limit is set for the acquiring thread;
+    // call getRuntime()->updateStackTop() before using it on another one.
+    class Lease {
+    private:
+        ContextPool* pool_;
+        Entry* entry_;
+
+    public:
+        Lease(ContextPool* pool, Entry* entry);
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        Context& context() const;
+        Context& operator*() const { return context(); }
+        Context* operator->() const { return &context(); }
+
+        // Returns the context early; the lease is empty afterwards
+        void release() noexcept;
+    };
+
+    explicit ContextPool(ContextPoolOptions options = {});
+    ~ContextPool();
+
+    ContextPool(const ContextPool&) = delete;
+    ContextPool& operator=(const ContextPool&) = delete;
+
+    // Blocks until a context is available. Throws when called off the owning
+    // thread of a pool on a shared runtime, or once every entry is discarded.
+    Lease acquire();
+
+    // Contexts in the pool; an entry whose context cannot be recreated on
+    // release is dropped, shrinking the pool
+    size_t size() const;
+    size_t available() const;
+    ContextPoolMetrics getMetrics() const;
+
+private:
+    ContextPoolOptions options_;
+    std::thread::id owner_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+    std::vector<Entry*> idle_;
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    ContextPoolMetrics metrics_;
+
+    std::unique_ptr<Entry> createEntry();
+    std::unique_ptr<Context> newContext(const std::shared_ptr<Runtime>& runtime);
+    // Replaces the entry's context; returns whether its runtime was replaced
+    bool recycle(Entry& entry);
+    // Never throws: it runs from Lease destructors
+    void release(Entry* entry) noexcept;
+};
+
+} // namespace QuickJSWrapper
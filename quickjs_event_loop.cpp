@@ -0,0 +1,660 @@
+#include "quickjs_event_loop.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace QuickJSWrapper {
+
+namespace {
+    // Longest timer delay in ms, as in browsers; longer delays are clamped so
+    // the expiry tick can neither overflow nor reach TimerWheel::kNever
+    constexpr double kMaxTimerDelay = 2147483647.0;
+    // Timer ids are handed to JS as numbers, exact below 2^53
+    constexpr double kMaxTimerId = 9007199254740992.0;
+
+    Value newError(Context& ctx, const std::string& message) {
+        JSContext* jsCtx = ctx.getJSContext();
+        JSValue error = JS_NewError(jsCtx);
+        if (JS_IsException(error)) {
+            detail::throwPendingException(jsCtx, "Failed to create error");
+        }
+        Value result = Value::adopt(jsCtx, error);
+        result.setProperty("message", ctx.newString(message));
+        return result;
+    }
+}
+
+// Tasks handed to the loop by other threads. Shared with resolvers, which may
+// outlive the loop; once it is closed new tasks are dropped.
+struct EventLoop::Inbox {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<std::function<void()>> tasks;
+    bool closed = false;
+    int eventFd = -1;
+
+    void push(std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed) {
+            return;
+        }
+        tasks.push_back(std::move(task));
+#ifdef __linux__
+        if (eventFd >= 0) {
+            uint64_t one = 1;
+            if (write(eventFd, &one, sizeof(one)) < 0) {
+                // Counter saturated; the descriptor is readable regardless
+            }
+        }
+#endif
+        ready.notify_one();
+    }
+};
+
+struct EventLoop::ResolverState {
+    std::shared_ptr<Inbox> inbox;
+    EventLoop* loop = nullptr;
+    uint64_t id = 0;
+    std::atomic<bool> settled{false};
+
+    // The task runs inside the loop, so 'loop' is alive whenever it does
+    void settle(bool fulfilled, std::function<Value(Context&)> make) {
+        if (settled.exchange(true)) {
+            return;
+        }
+        inbox->push([loop = loop, id = id, fulfilled, make = std::move(make)]() {
+            loop->settle(id, fulfilled, make);
+        });
+    }
+
+    ~ResolverState() {
+        settle(false, [](Context& ctx) {
+            return newError(ctx, "Promise was abandoned before being settled");
+        });
+    }
+};
+
+// Resolver implementation
+void EventLoop::Resolver::resolveWith(std::function<Value(Context&)> make) {
+    if (!state_) {
+        throw Exception("Promise resolver has been moved from");
+    }
+    state_->settle(true, std::move(make));
+}
+
+void EventLoop::Resolver::resolve() {
+    resolveWith([](Context& ctx) { return ctx.newUndefined(); });
+}
+
+void EventLoop::Resolver::reject(const std::string& message) {
+    if (!state_) {
+        throw Exception("Promise resolver has been moved from");
+    }
+    state_->settle(false, [message](Context& ctx) { return newError(ctx, message); });
+}
+
+// TimerWheel implementation
+TimerWheel::TimerWheel() = default;
+
+uint32_t TimerWheel::listFor(uint64_t expires) const {
+    if (expires <= now_) {
+        return kReady;
+    }
+    // The level is the lowest whose window (all higher bits) still matches now
+    for (unsigned level = 0; level < kLevels; ++level) {
+        unsigned shift = kSlotBits * (level + 1);
+        if ((expires >> shift) == (now_ >> shift)) {
+            return level * kSlots + ((expires >> (kSlotBits * level)) & (kSlots - 1));
+        }
+    }
+    return kOverflow;
+}
+
+void TimerWheel::link(uint32_t node, uint32_t list) {
+    Node& n = nodes_[node];
+    List& l = lists_[list];
+    n.list = list;
+    n.prev = l.tail;
+    n.next = kNil;
+    if (l.tail != kNil) {
+        nodes_[l.tail].next = node;
+    } else {
+        l.head = node;
+    }
+    l.tail = node;
+    levelCounts_[levelOf(list)]++;
+}
+
+void TimerWheel::unlink(uint32_t node) {
+    Node& n = nodes_[node];
+    List& l = lists_[n.list];
+    if (n.prev != kNil) {
+        nodes_[n.prev].next = n.next;
+    } else {
+        l.head = n.next;
+    }
+    if (n.next != kNil) {
+        nodes_[n.next].prev = n.prev;
+    } else {
+        l.tail = n.prev;
+    }
+    levelCounts_[levelOf(n.list)]--;
+}
+
+void TimerWheel::schedule(Id id, uint64_t expires) {
+    cancel(id);
+
+    uint32_t node;
+    if (!freeNodes_.empty()) {
+        node = freeNodes_.back();
+        freeNodes_.pop_back();
+    } else {
+        node = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back(Node{});
+    }
+    nodes_[node].id = id;
+    nodes_[node].expires = expires;
+    link(node, listFor(expires));
+    index_[id] = node;
+}
+
+bool TimerWheel::cancel(Id id) {
+    auto it = index_.find(id);
+    if (it == index_.end()) {
+        return false;
+    }
+    unlink(it->second);
+    freeNodes_.push_back(it->second);
+    index_.erase(it);
+    return true;
+}
+
+void TimerWheel::cascade(uint32_t list) {
+    // Detach first: overflow timers may land back in the overflow list
+    uint32_t node = lists_[list].head;
+    lists_[list] = List{};
+    while (node != kNil) {
+        uint32_t next = nodes_[node].next;
+        levelCounts_[levelOf(list)]--;
+        link(node, listFor(nodes_[node].expires));
+        node = next;
+    }
+}
+
+void TimerWheel::collect(uint32_t list, std::vector<Id>& due) {
+    uint32_t node = lists_[list].head;
+    lists_[list] = List{};
+    while (node != kNil) {
+        uint32_t next = nodes_[node].next;
+        levelCounts_[levelOf(list)]--;
+        due.push_back(nodes_[node].id);
+        index_.erase(nodes_[node].id);
+        freeNodes_.push_back(node);
+        node = next;
+    }
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<Id>& due) {
+    collect(kReady, due);
+    while (now_ < now) {
+        if (index_.empty()) {
+            now_ = now;
+            break;
+        }
+
+        // Nothing fires before the next boundary of the lowest occupied level
+        unsigned lowest = 0;
+        while (lowest < kLevels && levelCounts_[lowest] == 0) {
+            ++lowest;
+        }
+        if (lowest > 0) {
+            uint64_t span = uint64_t(1) << (kSlotBits * lowest);
+            now_ = std::min(now, (now_ / span + 1) * span - 1);
+            if (now_ >= now) {
+                break;
+            }
+        }
+
+        ++now_;
+        for (unsigned level = 1; level <= kLevels; ++level) {
+            if ((now_ & ((uint64_t(1) << (kSlotBits * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level == kLevels ? kOverflow
+                                     : level * kSlots + ((now_ >> (kSlotBits * level)) & (kSlots - 1)));
+        }
+        collect(kReady, due);
+        collect(now_ & (kSlots - 1), due);
+    }
+}
+
+uint64_t TimerWheel::nextExpiry() const {
+    if (index_.empty()) {
+        return kNever;
+    }
+    if (lists_[kReady].head != kNil) {
+        return now_;
+    }
+
+    auto earliest = [this](uint32_t list) {
+        uint64_t result = kNever;
+        for (uint32_t node = lists_[list].head; node != kNil; node = nodes_[node].next) {
+            result = std::min(result, nodes_[node].expires);
+        }
+        return result;
+    };
+
+    // Levels cover successive windows, so the first occupied slot wins
+    for (unsigned level = 0; level < kLevels; ++level) {
+        if (levelCounts_[level] == 0) {
+            continue;
+        }
+        unsigned current = (now_ >> (kSlotBits * level)) & (kSlots - 1);
+        for (unsigned slot = current + 1; slot < kSlots; ++slot) {
+            uint32_t list = level * kSlots + slot;
+            if (lists_[list].head != kNil) {
+                return earliest(list);
+            }
+        }
+    }
+    return earliest(kOverflow);
+}
+
+// EventLoop implementation
+EventLoop::EventLoop(Context& ctx)
+    : ctx_(ctx),
+      epoch_(std::chrono::steady_clock::now()),
+      inbox_(std::make_shared<Inbox>()),
+      self_(std::make_shared<std::atomic<EventLoop*>>(this)) {
+#ifdef __linux__
+    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    inbox_->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    pollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    for (int source : {timerFd_, inbox_->eventFd}) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = source;
+        if (pollFd_ >= 0 && (source < 0 || epoll_ctl(pollFd_, EPOLL_CTL_ADD, source, &event) < 0)) {
+            close(pollFd_);
+            pollFd_ = -1;
+        }
+    }
+#endif
+    installGlobals();
+}
+
+EventLoop::~EventLoop() {
+    // Later posts and settlements are dropped; the tasks are destroyed
+    // outside the lock since they may own resolvers
+    std::vector<std::function<void()>> dropped;
+    int eventFd;
+    {
+        std::lock_guard<std::mutex> lock(inbox_->mutex);
+        inbox_->closed = true;
+        dropped.swap(inbox_->tasks);
+        eventFd = inbox_->eventFd;
+        inbox_->eventFd = -1;
+    }
+    dropped.clear();
+    posted_.clear();
+    promises_.clear();
+
+    // Functions a script kept a reference to now fail instead of dangling
+    self_->store(nullptr);
+    try {
+        Value global = ctx_.getGlobal();
+        for (const char* name : {"setTimeout", "setInterval", "clearTimeout", "clearInterval"}) {
+            PropertyKey key = ctx_.newPropertyKey(name);
+            JS_DeleteProperty(ctx_.getJSContext(), global.getJSValue(), key.getAtom(), 0);
+        }
+    } catch (const Exception&) {
+    }
+    due_.clear();
+    timers_.clear();
+#ifdef __linux__
+    for (int fd : {pollFd_, timerFd_, eventFd}) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#else
+    (void)eventFd;
+#endif
+}
+
+uint64_t EventLoop::currentTick() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - epoch_).count();
+}
+
+void EventLoop::installGlobals() {
+    std::shared_ptr<std::atomic<EventLoop*>> self = self_;
+    auto loop = [self]() -> EventLoop& {
+        EventLoop* loop = self->load();
+        if (!loop) {
+            throw Exception("Event loop has been destroyed");
+        }
+        return *loop;
+    };
+
+    ctx_.setGlobalFunction("setTimeout", [loop](const std::vector<Value>& args) -> Value {
+        return loop().addTimer(args, false);
+    });
+    ctx_.setGlobalFunction("setInterval", [loop](const std::vector<Value>& args) -> Value {
+        return loop().addTimer(args, true);
+    });
+    ctx_.setGlobalFunction("clearTimeout", [loop](const std::vector<Value>& args) -> Value {
+        loop().clearTimer(args);
+        return loop().ctx_.newUndefined();
+    });
+    ctx_.setGlobalFunction("clearInterval", [loop](const std::vector<Value>& args) -> Value {
+        loop().clearTimer(args);
+        return loop().ctx_.newUndefined();
+    });
+}
+
+Value EventLoop::addTimer(const std::vector<Value>& args, bool repeat) {
+    if (args.empty() || !args[0].isFunction()) {
+        throw Exception("Timer callback must be a function");
+    }
+    double delay = args.size() > 1 ? args[1].toNumber() : 0;
+    // NaN and negative delays run on the next turn; Infinity is clamped
+    uint64_t ms = delay > 0 ? static_cast<uint64_t>(std::min(delay, kMaxTimerDelay)) : 0;
+
+    Timer timer{args[0], {}, repeat ? std::max<uint64_t>(ms, 1) : 0};
+    if (args.size() > 2) {
+        timer.args.assign(args.begin() + 2, args.end());
+    }
+
+    uint64_t id = nextTimerId_++;
+    uint64_t expires = currentTick() + ms;
+    timers_.emplace(id, std::move(timer));
+    wheel_.schedule(id, expires);
+    if (expires < armedTick_) {
+        armTimerFd();
+    }
+    return ctx_.newNumber(static_cast<double>(id));
+}
+
+void EventLoop::clearTimer(const std::vector<Value>& args) {
+    if (args.empty() || !args[0].isNumber()) {
+        return;
+    }
+    double number = args[0].toNumber();
+    if (!(number >= 1 && number < kMaxTimerId) || std::trunc(number) != number) {
+        return;
+    }
+    auto id = static_cast<uint64_t>(number);
+    // A due timer not yet run is skipped once it is gone from timers_
+    if (timers_.erase(id)) {
+        wheel_.cancel(id);
+    }
+}
+
+void EventLoop::post(std::function<void()> task) {
+    inbox_->push(std::move(task));
+}
+
+bool EventLoop::hasPostedTasks() const {
+    std::lock_guard<std::mutex> lock(inbox_->mutex);
+    return !inbox_->tasks.empty();
+}
+
+EventLoop::PendingPromise EventLoop::newPromise() {
+    JSContext* ctx = ctx_.getJSContext();
+    JSValue functions[2];
+    JSValue promise = JS_NewPromiseCapability(ctx, functions);
+    if (JS_IsException(promise)) {
+        detail::throwPendingException(ctx, "Failed to create promise");
+    }
+    Value result = Value::adopt(ctx, promise);
+    Settlers settlers{Value::adopt(ctx, functions[0]), Value::adopt(ctx, functions[1])};
+
+    auto state = std::make_shared<ResolverState>();
+    state->inbox = inbox_;
+    state->loop = this;
+    state->id = nextPromiseId_++;
+    promises_.emplace(state->id, std::move(settlers));
+    return PendingPromise{std::move(result), Resolver(std::move(state))};
+}
+
+void EventLoop::settle(uint64_t id, bool fulfilled, const std::function<Value(Context&)>& make) {
+    auto it = promises_.find(id);
+    if (it == promises_.end()) {
+        return;
+    }
+    Settlers settlers = std::move(it->second);
+    promises_.erase(it);
+
+    std::optional<Value> result;
+    try {
+        result = make(ctx_);
+    } catch (const std::exception& e) {
+        fulfilled = false;
+        result = newError(ctx_, e.what());
+    }
+    (fulfilled ? settlers.resolve : settlers.reject).call({*result});
+}
+
+std::exception_ptr EventLoop::rejection(const Value& reason) {
+    std::string message;
+    try {
+        message = reason.toString();
+    } catch (const Exception&) {
+        message = "<unprintable reason>";
+    }
+    return std::make_exception_ptr(Exception("Promise rejected: " + message));
+}
+
+void EventLoop::onSettled(const Value& promise,
+                          std::function<void(bool fulfilled, const Value& result)> callback) {
+    JSContext* ctx = ctx_.getJSContext();
+    if (!JS_IsPromise(promise.getJSValue())) {
+        callback(true, promise);
+        return;
+    }
+
+    JSPromiseStateEnum state = JS_PromiseState(ctx, promise.getJSValue());
+    if (state != JS_PROMISE_PENDING) {
+        Value result = Value::adopt(ctx, JS_PromiseResult(ctx, promise.getJSValue()));
+        callback(state == JS_PROMISE_FULFILLED, result);
+        return;
+    }
+
+    // The reactions may run after the loop is gone, so they hold the context
+    auto shared = std::make_shared<std::function<void(bool, const Value&)>>(std::move(callback));
+    Context* owner = &ctx_;
+    auto reaction = [shared, owner](bool fulfilled) {
+        return [shared, owner, fulfilled](const std::vector<Value>& args) -> Value {
+            (*shared)(fulfilled, args.empty() ? owner->newUndefined() : args[0]);
+            return owner->newUndefined();
+        };
+    };
+    promise.callMethod("then", {ctx_.newFunction("", reaction(true)),
+                                ctx_.newFunction("", reaction(false))});
+}
+
+std::future<Value> EventLoop::toFuture(const Value& promise) {
+    auto result = std::make_shared<std::promise<Value>>();
+    std::future<Value> future = result->get_future();
+    onSettled(promise, [result](bool fulfilled, const Value& value) {
+        if (fulfilled) {
+            result->set_value(value);
+        } else {
+            result->set_exception(rejection(value));
+        }
+    });
+    return future;
+}
+
+Value EventLoop::await(const Value& promise) {
+    std::future<Value> future = toFuture(promise);
+    auto settled = [&future]() {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+    while (!settled()) {
+        bool more = runOnce();
+        if (settled()) {
+            break;
+        }
+        if (!more) {
+            throw Exception("Failed to await promise: no pending work can settle it");
+        }
+        waitForWork(timeUntilNextTimer());
+    }
+    return future.get();
+}
+
+bool EventLoop::hasPendingJobs() const {
+    return JS_IsJobPending(ctx_.getJSRuntime());
+}
+
+size_t EventLoop::runPendingJobs() {
+    JSRuntime* rt = ctx_.getJSRuntime();
+    size_t count = 0;
+    while (true) {
+        JSContext* jobCtx = nullptr;
+        int result = JS_ExecutePendingJob(rt, &jobCtx);
+        if (result == 0) {
+            break;
+        }
+        if (result < 0) {
+            detail::throwPendingException(jobCtx, "Pending job failed");
+        }
+        ++count;
+    }
+    return count;
+}
+
+bool EventLoop::runOnce() {
+#ifdef __linux__
+    // Acknowledge before draining so a post racing with the drain stays signalled
+    for (int fd : {timerFd_, inbox_->eventFd}) {
+        uint64_t count;
+        if (fd >= 0 && read(fd, &count, sizeof(count)) < 0) {
+            // Not signalled (EAGAIN); nothing to acknowledge
+        }
+    }
+    armedTick_ = TimerWheel::kNever;
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(inbox_->mutex);
+        for (auto& task : inbox_->tasks) {
+            posted_.push_back(std::move(task));
+        }
+        inbox_->tasks.clear();
+    }
+    while (!posted_.empty()) {
+        std::function<void()> task = std::move(posted_.front());
+        posted_.pop_front();
+        try {
+            task();
+        } catch (...) {
+            armTimerFd();
+            throw;
+        }
+    }
+
+    runPendingJobs();
+
+    scratch_.clear();
+    wheel_.advance(currentTick(), scratch_);
+    due_.insert(due_.end(), scratch_.begin(), scratch_.end());
+
+    // Only timers due now; ones scheduled by these callbacks wait for the
+    // next call, so zero-delay chains cannot starve the caller
+    for (size_t count = due_.size(); count > 0 && !due_.empty(); --count) {
+        TimerWheel::Id id = due_.front();
+        due_.pop_front();
+        auto it = timers_.find(id);
+        if (it == timers_.end()) {
+            continue;
+        }
+
+        Value callback = it->second.callback;
+        std::vector<Value> args = it->second.args;
+        if (it->second.interval != 0) {
+            wheel_.schedule(id, currentTick() + it->second.interval);
+        } else {
+            timers_.erase(it);
+        }
+
+        try {
+            callback.call(args);
+            runPendingJobs();
+        } catch (...) {
+            armTimerFd();
+            throw;
+        }
+    }
+
+    armTimerFd();
+    return hasPendingJobs() || !timers_.empty() || !promises_.empty() || hasPostedTasks();
+}
+
+void EventLoop::run() {
+    while (runOnce()) {
+        waitForWork(timeUntilNextTimer());
+    }
+}
+
+void EventLoop::waitForWork(std::chrono::milliseconds timeout) {
+    if (timeout.count() == 0) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(inbox_->mutex);
+    auto posted = [this]() { return !inbox_->tasks.empty(); };
+    if (timeout == std::chrono::milliseconds::max()) {
+        inbox_->ready.wait(lock, posted);
+    } else {
+        inbox_->ready.wait_for(lock, timeout, posted);
+    }
+}
+
+std::chrono::milliseconds EventLoop::timeUntilNextTimer() const {
+    if (hasPendingJobs() || !due_.empty() || !posted_.empty() || hasPostedTasks()) {
+        return std::chrono::milliseconds(0);
+    }
+    uint64_t next = wheel_.nextExpiry();
+    if (next == TimerWheel::kNever) {
+        return std::chrono::milliseconds::max();
+    }
+    uint64_t now = currentTick();
+    return std::chrono::milliseconds(next > now ? next - now : 0);
+}
+
+void EventLoop::armTimerFd() {
+#ifdef __linux__
+    if (timerFd_ < 0) {
+        return;
+    }
+    uint64_t next = hasPendingJobs() || !due_.empty() || !posted_.empty()
+        ? currentTick() : wheel_.nextExpiry();
+    if (next == armedTick_) {
+        return;
+    }
+    armedTick_ = next;
+
+    // steady_clock is CLOCK_MONOTONIC on Linux; a deadline in the past fires at once
+    itimerspec spec{};
+    if (next != TimerWheel::kNever) {
+        auto deadline = (epoch_ + std::chrono::milliseconds(next)).time_since_epoch();
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(deadline);
+        spec.it_value.tv_sec = seconds.count();
+        spec.it_value.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - seconds).count();
+    }
+    timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+#endif
+}
+
+} // namespace QuickJSWrapper
@@ -0,0 +1,314 @@
+#pragma once
+
+#include "quickjs_wrapper.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define QUICKJS_WRAPPER_HAS_COROUTINES 1
+#endif
+
+namespace QuickJSWrapper {
+
+class ThreadPool;
+
+// Hierarchical timing wheel over integer ticks. Four levels of 64 slots
+// cover 2^24 ticks ahead of the current time; later timers wait in an
+// overflow list and cascade down as time advances. Schedule and cancel are
+// O(1); advancing costs one step per tick, skipping ranges with no timers
+// due in them.
+class TimerWheel {
+public:
+    using Id = uint64_t;
+    static constexpr uint64_t kNever = UINT64_MAX;
+
+    TimerWheel();
+
+    // Schedules id (replacing any earlier schedule of it) to fire at the
+    // absolute tick 'expires'; ticks not in the future fire on the next advance
+    void schedule(Id id, uint64_t expires);
+    bool cancel(Id id);
+
+    // Moves time forward to 'now' and appends the ids that became due, in
+    // expiry order
+    void advance(uint64_t now, std::vector<Id>& due);
+
+    // Earliest tick at which a timer is due (kNever when empty)
+    uint64_t nextExpiry() const;
+
+    uint64_t now() const { return now_; }
+    size_t size() const { return index_.size(); }
+    bool empty() const { return index_.empty(); }
+
+private:
+    static constexpr unsigned kLevels = 4;
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr unsigned kSlots = 1u << kSlotBits;
+    // Lists: kLevels * kSlots wheel slots, then overflow, then ready
+    static constexpr unsigned kOverflow = kLevels * kSlots;
+    static constexpr unsigned kReady = kOverflow + 1;
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Node {
+        Id id;
+        uint64_t expires;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t list;
+    };
+
+    struct List {
+        uint32_t head = kNil;
+        uint32_t tail = kNil;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> freeNodes_;
+    std::unordered_map<Id, uint32_t> index_;
+    std::array<List, kReady + 1> lists_;
+    // Timers per level; overflow and ready count as levels kLevels and kLevels + 1
+    std::array<size_t, kLevels + 2> levelCounts_{};
+    uint64_t now_ = 0;
+
+    uint32_t listFor(uint64_t expires) const;
+    void link(uint32_t node, uint32_t list);
+    void unlink(uint32_t node);
+    void cascade(uint32_t list);
+    void collect(uint32_t list, std::vector<Id>& due);
+    static unsigned levelOf(uint32_t list) { return list < kOverflow ? list / kSlots : kLevels + (list - kOverflow); }
+};
+
+// Promise job draining and timers (setTimeout, setInterval, clearTimeout,
+// clearInterval) for one context. The loop installs the timer functions as
+// globals and must be destroyed before its context.
+//
+// Drive it with run(), which blocks until no jobs, timers, posted tasks or
+// unsettled newPromise() promises are left, or from an external poller: on
+// Linux fd() becomes readable when the next timer is due or work is posted
+// from another thread; call runOnce() when it is, and after any evaluation
+// that may have queued promise jobs.
+//
+// Only post() and Resolver may be used from other threads.
+class EventLoop {
+private:
+    struct Inbox;
+    struct ResolverState;
+
+public:
+    // Settles one newPromise() promise from any thread. Copies share the
+    // promise; only the first settlement counts, and if the last copy goes
+    // away unsettled the promise is rejected.
+    class Resolver {
+    public:
+        // Builds the value on the loop thread, where JS values can be made;
+        // an exception thrown by 'make' rejects the promise instead
+        void resolveWith(std::function<Value(Context&)> make);
+        // Resolves with a C++ value converted like a typed binding result
+        template <typename T>
+        void resolve(T value);
+        void resolve();
+        void reject(const std::string& message);
+
+    private:
+        friend class EventLoop;
+        explicit Resolver(std::shared_ptr<ResolverState> state) : state_(std::move(state)) {}
+        std::shared_ptr<ResolverState> state_;
+    };
+
+    struct PendingPromise {
+        Value promise;
+        Resolver resolver;
+    };
+
+#ifdef QUICKJS_WRAPPER_HAS_COROUTINES
+    // co_await support; resumes the coroutine on the loop thread once the
+    // promise settles, yielding its value or throwing Exception on rejection
+    class PromiseAwaiter {
+    public:
+        PromiseAwaiter(EventLoop& loop, Value promise);
+        bool await_ready() const { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        Value await_resume();
+
+    private:
+        struct State {
+            bool settled = false;
+            bool suspended = false;
+            std::optional<Value> result;
+            std::exception_ptr error;
+            std::coroutine_handle<> handle;
+        };
+        EventLoop& loop_;
+        Value promise_;
+        std::shared_ptr<State> state_;
+    };
+#endif
+
+    explicit EventLoop(Context& ctx);
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // Errors thrown by timer callbacks and jobs propagate as exceptions; the
+    // loop stays consistent and can be run again
+    void run();
+    // Runs pending jobs and due timers without blocking; returns whether
+    // work remains
+    bool runOnce();
+    // Executes queued promise jobs (runtime-wide); returns how many ran
+    size_t runPendingJobs();
+
+    // Queues a task to run on the loop thread during the next runOnce();
+    // callable from any thread
+    void post(std::function<void()> task);
+
+    // A pending promise for a native function to return, settled later
+    // (typically from a worker thread) through its resolver
+    PendingPromise newPromise();
+
+    // Calls 'callback' on the loop thread with the outcome once 'promise'
+    // settles; at once if it already has. Values that are not promises count
+    // as fulfilled with themselves.
+    void onSettled(const Value& promise,
+                   std::function<void(bool fulfilled, const Value& result)> callback);
+    // Future fulfilled as the loop runs. The value belongs to this context:
+    // take it on the loop thread, or copy what is needed out of it there.
+    std::future<Value> toFuture(const Value& promise);
+    // Runs the loop until 'promise' settles and returns its value; throws
+    // Exception if it is rejected or nothing is left that could settle it
+    Value await(const Value& promise);
+#ifdef QUICKJS_WRAPPER_HAS_COROUTINES
+    PromiseAwaiter awaitable(const Value& promise) { return PromiseAwaiter(*this, promise); }
+#endif
+
+    Context& context() const { return ctx_; }
+    bool hasPendingJobs() const;
+    size_t pendingTimers() const { return timers_.size(); }
+    size_t pendingPromises() const { return promises_.size(); }
+    // Zero when work is ready, max() when nothing is scheduled
+    std::chrono::milliseconds timeUntilNextTimer() const;
+
+    // Pollable descriptor (an epoll set of the timerfd and the wakeup
+    // eventfd), or -1 where unsupported
+    int fd() const { return pollFd_; }
+
+private:
+    struct Timer {
+        Value callback;
+        std::vector<Value> args;
+        // Repeat period in ms for intervals, 0 for timeouts
+        uint64_t interval;
+    };
+
+    // Resolving functions of a newPromise() promise
+    struct Settlers {
+        Value resolve;
+        Value reject;
+    };
+
+    Context& ctx_;
+    TimerWheel wheel_;
+    std::unordered_map<uint64_t, Timer> timers_;
+    // Due timers not yet run, kept across runOnce calls if a callback throws
+    std::deque<TimerWheel::Id> due_;
+    std::vector<TimerWheel::Id> scratch_;
+    uint64_t nextTimerId_ = 1;
+    std::chrono::steady_clock::time_point epoch_;
+    int timerFd_ = -1;
+    int pollFd_ = -1;
+    uint64_t armedTick_ = TimerWheel::kNever;
+    std::shared_ptr<Inbox> inbox_;
+    // Tasks taken from the inbox and not yet run
+    std::deque<std::function<void()>> posted_;
+    std::unordered_map<uint64_t, Settlers> promises_;
+    uint64_t nextPromiseId_ = 1;
+    // Shared with the installed JS functions, cleared on destruction. Atomic
+    // so the clear is seen by the thread that calls them next; destruction
+    // must still not overlap a call.
+    std::shared_ptr<std::atomic<EventLoop*>> self_;
+
+    template <typename F>
+    friend void bindAsyncGlobalFunction(EventLoop& loop, ThreadPool& pool, const std::string& name, F&& func);
+
+    uint64_t currentTick() const;
+    void installGlobals();
+    Value addTimer(const std::vector<Value>& args, bool repeat);
+    void clearTimer(const std::vector<Value>& args);
+    void armTimerFd();
+    void waitForWork(std::chrono::milliseconds timeout);
+    bool hasPostedTasks() const;
+    void settle(uint64_t id, bool fulfilled, const std::function<Value(Context&)>& make);
+    static std::exception_ptr rejection(const Value& reason);
+};
+
+namespace detail {
+    // Resolver values are plain C++ data converted on the loop thread; string
+    // literals and views are copied so they outlive the caller
+    template <typename T>
+    using ResolvedType = std::conditional_t<std::is_convertible_v<T, std::string_view>,
+                                            std::string, std::decay_t<T>>;
+}
+
+#ifdef QUICKJS_WRAPPER_HAS_COROUTINES
+inline EventLoop::PromiseAwaiter::PromiseAwaiter(EventLoop& loop, Value promise)
+    : loop_(loop), promise_(std::move(promise)), state_(std::make_shared<State>()) {
+}
+
+inline bool EventLoop::PromiseAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    std::shared_ptr<State> state = state_;
+    state->handle = handle;
+    loop_.onSettled(promise_, [state](bool fulfilled, const Value& result) {
+        state->settled = true;
+        if (fulfilled) {
+            state->result = result;
+        } else {
+            state->error = rejection(result);
+        }
+        if (state->suspended) {
+            state->handle.resume();
+        }
+    });
+    // Already settled: continue without suspending
+    if (state->settled) {
+        return false;
+    }
+    state->suspended = true;
+    return true;
+}
+
+inline Value EventLoop::PromiseAwaiter::await_resume() {
+    if (state_->error) {
+        std::rethrow_exception(state_->error);
+    }
+    return std::move(*state_->result);
+}
+#endif
+
+template <typename T>
+void EventLoop::Resolver::resolve(T value) {
+    using Stored = detail::ResolvedType<T>;
+    static_assert(!std::is_same_v<Stored, Value> && !std::is_same_v<Stored, ValueRef>,
+                  "Values belong to the loop thread; build them with resolveWith");
+    resolveWith([value = Stored(std::move(value))](Context& ctx) {
+        JSContext* jsCtx = ctx.getJSContext();
+        return Value::adopt(jsCtx, detail::Converter<Stored>::toJS(jsCtx, value));
+    });
+}
+
+} // namespace QuickJSWrapper
@@ -0,0 +1,219 @@
+#include "quickjs_executor.h"
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace QuickJSWrapper {
+
+namespace {
+    // Identifies the executor worker running on the current thread, so that
+    // jobs submitted from inside a job stay on the local deque
+    thread_local const Executor* currentExecutor = nullptr;
+    thread_local size_t currentWorker = 0;
+
+    void pinCurrentThread(size_t index) {
+#ifdef __linux__
+        unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cpus, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)index;
+#endif
+    }
+}
+
+Executor::Executor(ExecutorOptions options)
+    : options_(std::move(options)) {
+    size_t count = options_.threads;
+    if (count == 0) {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Create all deques before any worker starts stealing from them
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+
+    std::vector<std::future<void>> ready;
+    ready.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::promise<void> promise;
+        ready.push_back(promise.get_future());
+        workers_[i]->thread = std::thread(&Executor::workerLoop, this, i, std::move(promise));
+    }
+
+    // Surface initializer failures from the constructor
+    try {
+        for (auto& future : ready) {
+            future.get();
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wakeup_.notify_all();
+        for (auto& worker : workers_) {
+            worker->thread.join();
+        }
+        throw;
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+std::future<std::vector<uint8_t>> Executor::submit(ScriptJob job) {
+    Task task{std::move(job), {}};
+    auto future = task.result.get_future();
+
+    size_t index = currentExecutor == this
+        ? currentWorker
+        : nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+
+    // Count the job before it becomes visible so pending_ never underflows, and
+    // under the sleep mutex so a worker about to wait cannot miss it
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        pending_.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    wakeup_.notify_one();
+    return future;
+}
+
+ExecutorMetrics Executor::getMetrics() const {
+    ExecutorMetrics metrics;
+    metrics.submitted = submitted_.load();
+    metrics.completed = completed_.load();
+    metrics.failed = failed_.load();
+    metrics.steals = steals_.load();
+    return metrics;
+}
+
+bool Executor::takeTask(size_t index, Task& task) {
+    // Newest local job first, for cache locality
+    {
+        Worker& own = *workers_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Steal the oldest job from the other workers, starting with the neighbour
+    for (size_t offset = 1; offset < workers_.size(); ++offset) {
+        Worker& victim = *workers_[(index + offset) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending_.fetch_sub(1);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Executor::runTask(Context& ctx, Task& task) {
+    const ScriptJob& job = task.job;
+    try {
+        std::optional<DeadlineScope> deadline;
+        if (job.timeout.count() > 0) {
+            deadline.emplace(ctx, job.timeout);
+        }
+
+        Value result = ctx.newUndefined();
+        if (!job.bytecode.empty()) {
+            result = ctx.loadScript(job.bytecode.data(), job.bytecode.size()).run();
+        } else if (!job.source.empty()) {
+            result = ctx.eval(job.source, job.filename);
+        }
+
+        if (!job.function.empty()) {
+            Value fn = ctx.getGlobal().getProperty(job.function);
+            if (!fn.isFunction()) {
+                throw Exception("Executor job function is not defined: " + job.function);
+            }
+            std::vector<Value> args;
+            args.reserve(job.args.size());
+            for (const auto& arg : job.args) {
+                args.push_back(ctx.deserialize(arg));
+            }
+            result = fn.call(args);
+        }
+
+        task.result.set_value(result.serialize());
+        completed_.fetch_add(1, std::memory_order_relaxed);
+    } catch (...) {
+        task.result.set_exception(std::current_exception());
+        failed_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Executor::workerLoop(size_t index, std::promise<void> ready) {
+    if (options_.pinThreads) {
+        pinCurrentThread(index);
+    }
+
+    // Runtime and context are created on the thread that uses them
+    std::unique_ptr<Context> ctx;
+    try {
+        ctx = std::make_unique<Context>();
+        if (options_.initializer) {
+            options_.initializer(*ctx);
+        }
+        ready.set_value();
+    } catch (...) {
+        ready.set_exception(std::current_exception());
+        return;
+    }
+
+    currentExecutor = this;
+    currentWorker = index;
+
+    Task task;
+    while (true) {
+        if (takeTask(index, task)) {
+            runTask(*ctx, task);
+            task = Task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wakeup_.wait(lock, [this]() { return stopping_ || pending_.load() > 0; });
+        if (stopping_ && pending_.load() == 0) {
+            break;
+        }
+    }
+
+    currentExecutor = nullptr;
+}
+
+} // namespace QuickJSWrapper
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "quickjs_wrapper.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace QuickJSWrapper {
+
+// A unit of work for the Executor. Values cross threads only in serialized
+// form (Value::serialize / Script::serialize), since JS values are bound to
+// the runtime that created them.
+struct ScriptJob {
+    // Either source or bytecode; bytecode takes precedence when both are set
+    std::string source;
+    std::vector<uint8_t> bytecode;
+    std::string filename = "<job>";
+    // Optional global function to call after the script has run (which may
+    // then be empty), with the deserialized arguments
+    std::string function;
+    std::vector<std::vector<uint8_t>> args;
+    // Wall-clock budget for the whole job (0 = unbounded); an overrun fails
+    // the job with TimeoutException and frees the worker
+    std::chrono::nanoseconds timeout{0};
+};
+
+struct ExecutorOptions {
+    // Number of worker threads; 0 uses std::thread::hardware_concurrency()
+    size_t threads = 0;
+    // Runs once on each worker's context before it accepts jobs, e.g. to load
+    // the library that jobs call into through ScriptJob::function
+    std::function<void(Context&)> initializer;
+    // Pin worker i to CPU i (mod the CPU count). Only honoured on Linux.
+    bool pinThreads = false;
+};
+
+struct ExecutorMetrics {
+    size_t submitted = 0;
+    size_t completed = 0;
+    size_t failed = 0;
+    size_t steals = 0;
+};
+
+// Runs script jobs on a fixed set of worker threads, each owning its own
+// Runtime and Context. Every worker has a local deque: jobs submitted from a
+// worker go to its own deque, external submissions are spread round-robin,
+// and idle workers steal from the front of other workers' deques.
+//
+// Worker contexts live for the lifetime of the executor, so globals a job
+// leaves behind are visible to later jobs on the same worker.
+class Executor {
+public:
+    explicit Executor(ExecutorOptions options = {});
+    // Drains all queued jobs, then joins the workers
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // Resolves to the serialized completion value (or function result), to be
+    // read back with Context::deserialize. Script errors are delivered as an
+    // Exception through the future.
+    std::future<std::vector<uint8_t>> submit(ScriptJob job);
+
+    size_t size() const { return workers_.size(); }
+    ExecutorMetrics getMetrics() const;
+
+private:
+    struct Task {
+        ScriptJob job;
+        std::promise<std::vector<uint8_t>> result;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    ExecutorOptions options_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex sleepMutex_;
+    std::condition_variable wakeup_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> nextWorker_{0};
+    bool stopping_ = false;
+
+    std::atomic<size_t> submitted_{0};
+    std::atomic<size_t> completed_{0};
+    std::atomic<size_t> failed_{0};
+    std::atomic<size_t> steals_{0};
+
+    void workerLoop(size_t index, std::promise<void> ready);
+    bool takeTask(size_t index, Task& task);
+    void runTask(Context& ctx, Task& task);
+};
+
+} // namespace QuickJSWrapper
@@ -0,0 +1,434 @@
+#include "quickjs_snapshot.h"
+#include <cctype>
+#include <set>
+#include <unordered_set>
+
+namespace QuickJSWrapper {
+
+namespace {
+    // Names of the string-keyed own properties of the global object
+    std::vector<std::string> globalNames(Context& ctx) {
+        JSContext* jsCtx = ctx.getJSContext();
+        JSValue global = JS_GetGlobalObject(jsCtx);
+        JSPropertyEnum* props = nullptr;
+        uint32_t count = 0;
+        if (JS_GetOwnPropertyNames(jsCtx, &props, &count, global, JS_GPN_STRING_MASK) < 0) {
+            JS_FreeValue(jsCtx, global);
+            throw Exception("Failed to enumerate global properties: " + ctx.getExceptionString());
+        }
+
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            names.push_back(PropertyKey(jsCtx, props[i].atom).toString());
+        }
+        JS_FreePropertyEnum(jsCtx, props, count);
+        JS_FreeValue(jsCtx, global);
+        return names;
+    }
+
+    // Describes everything reachable from the given built-in globals of
+    // 'global' through property descriptors and prototypes, without running
+    // any getter. Two contexts print the same text exactly when no built-in
+    // was changed.
+    constexpr const char* kBuiltinFingerprint = R"(
+        (function (global, roots) {
+            var seen = new Map([[global, 'globalThis']]);
+            var out = [];
+            function describe(value, path) {
+                if (value === null || (typeof value !== 'object' && typeof value !== 'function')) {
+                    return typeof value + ':' + String(value);
+                }
+                if (seen.has(value)) {
+                    return '@' + seen.get(value);
+                }
+                seen.set(value, path);
+                var parts = [typeof value === 'function' ? Function.prototype.toString.call(value) : 'object',
+                             'proto=' + describe(Object.getPrototypeOf(value), path + '.[[Prototype]]')];
+                var keys = Reflect.ownKeys(value);
+                for (var i = 0; i < keys.length; i++) {
+                    var key = String(keys[i]);
+                    var d = Object.getOwnPropertyDescriptor(value, keys[i]);
+                    var flags = (d.enumerable ? 'e' : '') + (d.configurable ? 'c' : '') + (d.writable ? 'w' : '');
+                    parts.push(key + '/' + flags + '=' + ('value' in d ? describe(d.value, path + '.' + key)
+                        : describe(d.get, path + '.get ' + key) + ',' + describe(d.set, path + '.set ' + key)));
+                }
+                out.push(path + ' {' + parts.join('; ') + '}');
+                return '@' + path;
+            }
+            for (var i = 0; i < roots.length; i++) {
+                var d = Object.getOwnPropertyDescriptor(global, roots[i]);
+                out.push(roots[i] + ' = ' + (d === undefined ? 'missing'
+                    : 'value' in d ? describe(d.value, roots[i]) : 'accessor'));
+            }
+            return out.join('\n');
+        })
+    )";
+
+    void appendUtf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xc0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3f));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xe0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (cp & 0x3f));
+        } else {
+            out += static_cast<char>(0xf0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (cp & 0x3f));
+        }
+    }
+
+    // Reads a \uXXXX or \u{X...} escape at 'pos'; returns false if there is none
+    bool readUnicodeEscape(const std::string& source, size_t& pos, std::string& out) {
+        if (pos + 1 >= source.size() || source[pos] != '\\' || source[pos + 1] != 'u') {
+            return false;
+        }
+        size_t i = pos + 2;
+        bool braced = i < source.size() && source[i] == '{';
+        if (braced) {
+            ++i;
+        }
+        uint32_t cp = 0;
+        size_t digits = 0;
+        while (i < source.size() && std::isxdigit(static_cast<unsigned char>(source[i])) &&
+               (braced || digits < 4) && digits < 8) {
+            char c = source[i++];
+            cp = cp * 16 + static_cast<uint32_t>(std::isdigit(static_cast<unsigned char>(c)) ? c - '0'
+                                                 : (std::tolower(static_cast<unsigned char>(c)) - 'a' + 10));
+            ++digits;
+        }
+        if (digits == 0 || (braced ? i >= source.size() || source[i] != '}' : digits != 4) || cp > 0x10ffff) {
+            return false;
+        }
+        pos = braced ? i + 1 : i;
+        appendUtf8(out, cp);
+        return true;
+    }
+
+    // Every identifier-like word in the source, escapes decoded. Words in
+    // strings and comments are included: a superset only costs extra probes.
+    std::set<std::string> sourceIdentifiers(const std::string& source) {
+        auto isPart = [](unsigned char c) {
+            return std::isalnum(c) || c == '_' || c == '$' || c >= 0x80;
+        };
+        std::set<std::string> names;
+        size_t pos = 0;
+        while (pos < source.size()) {
+            std::string name;
+            while (pos < source.size()) {
+                if (isPart(static_cast<unsigned char>(source[pos]))) {
+                    name += source[pos++];
+                } else if (!readUnicodeEscape(source, pos, name)) {
+                    break;
+                }
+            }
+            if (name.empty()) {
+                ++pos;
+            } else if (!std::isdigit(static_cast<unsigned char>(name[0]))) {
+                names.insert(name);
+            }
+        }
+        // Expressions that evaluate without naming a binding
+        for (const char* keyword : {"this", "null", "true", "false", "debugger"}) {
+            names.erase(keyword);
+        }
+        return names;
+    }
+
+    // Finds the first state under a global's value that JS_WriteObject would
+    // not reproduce: only plain objects and dense arrays holding ordinary
+    // data properties survive it. An object's class is checked before
+    // anything else is read from it, so proxies are turned away without
+    // running their traps, and only descriptors are read, so no getter runs.
+    class LossCheck {
+    public:
+        // 'ctx' holds the values; 'helpers' provides Object.getPrototypeOf
+        LossCheck(Context& helpers, Context& ctx)
+            : ctx_(ctx.getJSContext()),
+              getPrototypeOf_(helpers.eval("Object.getPrototypeOf", "<snapshot>")),
+              plainObject_(ctx.newObject()),
+              plainArray_(ctx.newArray()),
+              objectProto_(prototypeOf(plainObject_.getJSValue())),
+              arrayProto_(prototypeOf(plainArray_.getJSValue())),
+              objectClass_(JS_GetClassID(plainObject_.getJSValue())),
+              arrayClass_(JS_GetClassID(plainArray_.getJSValue())) {
+        }
+
+        // Empty when the value round-trips faithfully
+        std::string check(JSValueConst value, const std::string& path) {
+            if (!JS_IsObject(value) || !seen_.insert(JS_VALUE_GET_PTR(value)).second) {
+                return "";
+            }
+            if (JS_IsFunction(ctx_, value)) {
+                sawFunction_ = true;
+                return path + " is a function";
+            }
+            JSClassID classId = JS_GetClassID(value);
+            bool isArray = classId == arrayClass_;
+            if (!isArray && classId != objectClass_) {
+                return path + " is not a plain object or array";
+            }
+            const Value& expected = isArray ? arrayProto_ : objectProto_;
+            if (JS_VALUE_GET_PTR(prototypeOf(value).getJSValue()) != JS_VALUE_GET_PTR(expected.getJSValue())) {
+                return path + " is not a plain object or array";
+            }
+            if (JS_IsExtensible(ctx_, value) != 1) {
+                return path + " is frozen, sealed or not extensible";
+            }
+            if (countKeys(value, JS_GPN_SYMBOL_MASK) != 0) {
+                return path + " has a symbol-keyed property";
+            }
+
+            JSPropertyEnum* props = nullptr;
+            uint32_t count = 0;
+            if (JS_GetOwnPropertyNames(ctx_, &props, &count, value, JS_GPN_STRING_MASK) < 0) {
+                throw Exception("Failed to inspect " + path + ": " + takeException());
+            }
+            std::vector<PropertyKey> keys;
+            keys.reserve(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                keys.emplace_back(ctx_, props[i].atom);
+            }
+            JS_FreePropertyEnum(ctx_, props, count);
+
+            // Indices come first in ascending order, then 'length', which
+            // is a plain data property of arrays
+            if (isArray) {
+                size_t length = keys.empty() ? 0 : keys.size() - 1;
+                bool dense = !keys.empty() && keys[length].toString() == "length" &&
+                    Value::adopt(ctx_, JS_GetProperty(ctx_, value, keys[length].getAtom())).toNumber() == length;
+                for (size_t i = 0; dense && i < length; ++i) {
+                    dense = keys[i].toString() == std::to_string(i);
+                }
+                if (!dense) {
+                    return path + " is sparse or has named properties";
+                }
+                keys.pop_back();
+            }
+            for (size_t i = 0; i < keys.size(); ++i) {
+                std::string keyPath = path + "." + keys[i].toString();
+                JSPropertyDescriptor desc;
+                int found = JS_GetOwnProperty(ctx_, &desc, value, keys[i].getAtom());
+                if (found < 0) {
+                    throw Exception("Failed to inspect " + keyPath + ": " + takeException());
+                }
+                if (found == 0) {
+                    continue;
+                }
+                Value property = Value::adopt(ctx_, desc.value);
+                Value getter = Value::adopt(ctx_, desc.getter);
+                Value setter = Value::adopt(ctx_, desc.setter);
+                if (desc.flags & JS_PROP_GETSET) {
+                    return keyPath + " is an accessor";
+                }
+                if ((desc.flags & JS_PROP_C_W_E) != JS_PROP_C_W_E) {
+                    return keyPath + " is not writable, enumerable and configurable";
+                }
+                std::string problem = check(property.getJSValue(), keyPath);
+                if (!problem.empty()) {
+                    return problem;
+                }
+            }
+            return "";
+        }
+
+        // Whether the last failed check found a function
+        bool sawFunction() const { return sawFunction_; }
+
+        void reset() {
+            seen_.clear();
+            sawFunction_ = false;
+        }
+
+    private:
+        JSContext* ctx_;
+        Value getPrototypeOf_;
+        Value plainObject_;
+        Value plainArray_;
+        Value objectProto_;
+        Value arrayProto_;
+        JSClassID objectClass_;
+        JSClassID arrayClass_;
+        std::unordered_set<void*> seen_;
+        bool sawFunction_ = false;
+
+        // Only called on ordinary objects, where reading the prototype runs
+        // no script code
+        Value prototypeOf(JSValueConst value) {
+            return getPrototypeOf_.call({Value::dup(ctx_, value)});
+        }
+
+        uint32_t countKeys(JSValueConst value, int flags) {
+            JSPropertyEnum* props = nullptr;
+            uint32_t count = 0;
+            if (JS_GetOwnPropertyNames(ctx_, &props, &count, value, flags) < 0) {
+                throw Exception("Failed to inspect object: " + takeException());
+            }
+            JS_FreePropertyEnum(ctx_, props, count);
+            return count;
+        }
+
+        std::string takeException() {
+            return Value::adopt(ctx_, JS_GetException(ctx_)).toString();
+        }
+    };
+
+    // The helpers run in the pristine context, where the built-ins they use
+    // cannot have been replaced by the init script
+    std::string builtinFingerprint(Context& helpers, Context& ctx, const std::vector<std::string>& builtins) {
+        std::vector<Value> roots;
+        for (const auto& name : builtins) {
+            roots.push_back(helpers.newString(name));
+        }
+        return helpers.eval(kBuiltinFingerprint, "<snapshot>")
+            .call({ctx.getGlobal(), helpers.newArray(roots)}).toString();
+    }
+
+    // Whether 'name' is bound by a top-level let/const/class: declaring a
+    // var of the same name is then a redeclaration error. Words that are not
+    // identifiers are told apart by compiling the declaration elsewhere
+    // first. Neither step reads the binding, so no getter runs.
+    bool isLexicalBinding(Context& helpers, Context& ctx, const std::string& name) {
+        try {
+            helpers.compile("var " + name, "<snapshot>");
+        } catch (const Exception&) {
+            return false;
+        }
+        try {
+            ctx.eval("var " + name, "<snapshot>");
+        } catch (const Exception&) {
+            return true;
+        }
+        return false;
+    }
+}
+
+ContextSnapshot ContextSnapshot::capture(const std::string& initScript, const std::string& filename) {
+    ContextSnapshot snapshot;
+
+    // Both contexts share a runtime: one runs the script, the other provides
+    // the pristine set of global names to diff against
+    auto runtime = std::make_shared<Runtime>();
+    Context initialized(runtime);
+    Context pristine(runtime);
+
+    Script script = initialized.compile(initScript, filename);
+    snapshot.initBytecode_ = script.serialize();
+    script.run();
+
+    std::vector<std::string> builtins = globalNames(pristine);
+    std::unordered_set<std::string> builtinSet(builtins.begin(), builtins.end());
+
+    // Built-ins first: the lexical probe below declares vars in 'initialized'
+    if (builtinFingerprint(pristine, initialized, builtins) != builtinFingerprint(pristine, pristine, builtins)) {
+        snapshot.replayReasons_.push_back("built-in objects were modified");
+    }
+
+    JSContext* jsCtx = initialized.getJSContext();
+    Value data = initialized.newObject();
+    Value global = initialized.getGlobal();
+    LossCheck lossCheck(pristine, initialized);
+    for (const auto& name : globalNames(initialized)) {
+        if (builtinSet.count(name)) {
+            continue;
+        }
+        // The descriptor, not the property, so that no getter runs
+        PropertyKey key = initialized.newPropertyKey(name);
+        JSPropertyDescriptor desc;
+        int found = JS_GetOwnProperty(jsCtx, &desc, global.getJSValue(), key.getAtom());
+        if (found < 0) {
+            throw Exception("Failed to read global " + name + ": " + initialized.getExceptionString());
+        }
+        if (found == 0) {
+            continue;
+        }
+        Value value = Value::adopt(jsCtx, desc.value);
+        Value getter = Value::adopt(jsCtx, desc.getter);
+        Value setter = Value::adopt(jsCtx, desc.setter);
+        if (desc.flags & JS_PROP_GETSET) {
+            snapshot.replayReasons_.push_back("global is an accessor property: " + name);
+            continue;
+        }
+        // Checked before serializing, which would read array elements
+        // through any getters
+        lossCheck.reset();
+        std::string loss = lossCheck.check(value.getJSValue(), name);
+        if (lossCheck.sawFunction()) {
+            snapshot.unserializable_.push_back(name);
+            continue;
+        }
+        if (!loss.empty()) {
+            snapshot.replayReasons_.push_back("global would lose state when serialized: " + loss);
+            continue;
+        }
+        try {
+            value.serialize();
+        } catch (const Exception&) {
+            snapshot.unserializable_.push_back(name);
+            continue;
+        }
+        data.setProperty(name, value);
+        snapshot.captured_.push_back(name);
+        snapshot.capturedFlags_.push_back(desc.flags & JS_PROP_C_W_E);
+    }
+
+    // State that is not a global property can only be reproduced by replay
+    for (const auto& name : sourceIdentifiers(initScript)) {
+        if (name == "eval") {
+            snapshot.replayReasons_.push_back("the script calls eval");
+        }
+        if (isLexicalBinding(pristine, initialized, name)) {
+            snapshot.replayReasons_.push_back("top-level lexical binding: " + name);
+        }
+    }
+    for (const auto& name : snapshot.unserializable_) {
+        snapshot.replayReasons_.push_back("global holds a function or other unserializable value: " + name);
+    }
+
+    // One blob for all data globals keeps references shared between them
+    if (snapshot.replayReasons_.empty()) {
+        snapshot.globalData_ = data.serialize();
+    }
+    return snapshot;
+}
+
+std::unique_ptr<Context> ContextSnapshot::instantiate() const {
+    auto ctx = std::make_unique<Context>();
+    restoreInto(*ctx);
+    return ctx;
+}
+
+std::unique_ptr<Context> ContextSnapshot::instantiate(std::shared_ptr<Runtime> runtime) const {
+    auto ctx = std::make_unique<Context>(std::move(runtime));
+    restoreInto(*ctx);
+    return ctx;
+}
+
+void ContextSnapshot::restoreInto(Context& ctx) const {
+    if (requiresReplay()) {
+        ctx.loadScript(initBytecode_.data(), initBytecode_.size()).run();
+        return;
+    }
+
+    JSContext* jsCtx = ctx.getJSContext();
+    Value data = ctx.deserialize(globalData_);
+    Value global = ctx.getGlobal();
+
+    // Define the globals with the attributes they had: var declarations are
+    // not configurable, plain assignments to globalThis are
+    for (size_t i = 0; i < captured_.size(); ++i) {
+        PropertyKey key = ctx.newPropertyKey(captured_[i]);
+        JSValue value = JS_GetProperty(jsCtx, data.getJSValue(), key.getAtom());
+        if (JS_IsException(value) ||
+            JS_DefinePropertyValue(jsCtx, global.getJSValue(), key.getAtom(), value, capturedFlags_[i]) < 0) {
+            throw Exception("Failed to restore snapshot: " + ctx.getExceptionString());
+        }
+    }
+}
+
+} // namespace QuickJSWrapper
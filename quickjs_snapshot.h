@@ -0,0 +1,52 @@
+#pragma once
+
+#include "quickjs_wrapper.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace QuickJSWrapper {
+
+// State of a context after running an initialization script, captured once
+// and materialized into new contexts.
+//
+// Globals introduced by the script that hold plain data are serialized
+// together (preserving shared references) and restored with a single
+// JS_ReadObject, without running any script, keeping each global's property
+// attributes. Everything else falls back to replaying the precompiled init
+// bytecode, which still skips parsing: function globals, accessor globals,
+// data the serializer would not reproduce (objects other than plain objects
+// and dense arrays, and symbol-keyed, accessor, non-enumerable or read-only
+// properties and frozen objects anywhere in it), changes to built-in
+// objects (e.g. prototype polyfills) and top-level let/const/class bindings,
+// which are detected at capture by probing every identifier in the source.
+// Scripts calling eval always replay, since bindings they create need not
+// be named in the source. Capture reads property descriptors only, so no
+// getter defined by the script runs.
+class ContextSnapshot {
+public:
+    static ContextSnapshot capture(const std::string& initScript,
+                                   const std::string& filename = "<init>");
+
+    // Creates a context in the captured state, on a private or shared runtime
+    std::unique_ptr<Context> instantiate() const;
+    std::unique_ptr<Context> instantiate(std::shared_ptr<Runtime> runtime) const;
+    void restoreInto(Context& ctx) const;
+
+    bool requiresReplay() const { return !replayReasons_.empty(); }
+    // Why the captured state cannot be restored from data alone
+    const std::vector<std::string>& getReplayReasons() const { return replayReasons_; }
+    const std::vector<std::string>& getUnserializableGlobals() const { return unserializable_; }
+    const std::vector<std::string>& getCapturedGlobals() const { return captured_; }
+
+private:
+    std::vector<uint8_t> initBytecode_;
+    std::vector<uint8_t> globalData_;
+    std::vector<std::string> captured_;
+    // Property attributes of each captured global
+    std::vector<int> capturedFlags_;
+    std::vector<std::string> unserializable_;
+    std::vector<std::string> replayReasons_;
+};
+
+} // namespace QuickJSWrapper
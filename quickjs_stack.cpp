@@ -0,0 +1,133 @@
+#include "quickjs_stack.h"
+#include <algorithm>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace QuickJSWrapper {
+
+#ifndef _WIN32
+namespace {
+    size_t pageSize() {
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    struct StackCall {
+        Runtime* runtime;
+        const std::function<void()>* body;
+        size_t limit;
+    };
+
+    void* stackTrampoline(void* arg) {
+        auto* call = static_cast<StackCall*>(arg);
+        // The limit is measured from the stack top, so move it here first
+        call->runtime->updateStackTop();
+        JS_SetMaxStackSize(call->runtime->getJSRuntime(), call->limit);
+        (*call->body)();
+        return nullptr;
+    }
+}
+
+StackRunner::StackRunner(size_t stackSize)
+    : stackSize_(stackSize), stack_(nullptr) {
+    if (stackSize_ < 4 * kGuardSize) {
+        throw Exception("Stack runner size is too small: " + std::to_string(stackSize_));
+    }
+    stackSize_ = (stackSize_ + pageSize() - 1) & ~(pageSize() - 1);
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+#ifdef MAP_STACK
+    flags |= MAP_STACK;
+#endif
+    void* stack = mmap(nullptr, stackSize_, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (stack == MAP_FAILED) {
+        throw Exception("Failed to reserve stack runner stack");
+    }
+    stack_ = stack;
+
+    // Overflowing the native stack faults instead of corrupting memory
+    mprotect(stack_, pageSize(), PROT_NONE);
+}
+
+StackRunner::~StackRunner() {
+    if (stack_) {
+        munmap(stack_, stackSize_);
+    }
+}
+
+void StackRunner::runOnStack(Runtime& runtime, const std::function<void()>& body) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StackCall call{&runtime, &body, stackSize_ - kGuardSize};
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack_, stackSize_);
+    pthread_t thread;
+    int error = pthread_create(&thread, &attr, stackTrampoline, &call);
+    pthread_attr_destroy(&attr);
+    if (error != 0) {
+        throw Exception("Failed to start stack runner thread");
+    }
+    pthread_join(thread, nullptr);
+
+    // Evaluation continues on this thread with the configured limit
+    runtime.updateStackTop();
+    JS_SetMaxStackSize(runtime.getJSRuntime(), runtime.getMaxStackSize());
+
+    lastPeakUsage_ = measureAndRelease();
+    maxPeakUsage_ = std::max(maxPeakUsage_, lastPeakUsage_);
+}
+
+size_t StackRunner::measureAndRelease() {
+    size_t page = pageSize();
+    char* base = static_cast<char*>(stack_) + page;
+    size_t length = stackSize_ - page;
+    size_t peak = 0;
+
+#ifdef __linux__
+    // Stacks grow down: the lowest resident page marks the deepest frame.
+    // Pages only become resident when touched, so nothing is committed to
+    // measure them.
+    std::vector<unsigned char> resident(length / page);
+    if (mincore(base, length, resident.data()) == 0) {
+        auto lowest = std::find_if(resident.begin(), resident.end(),
+                                   [](unsigned char flags) { return flags & 1; });
+        if (lowest != resident.end()) {
+            char* low = base + (lowest - resident.begin()) * page;
+            // Untouched bytes of the deepest page are still zero
+            char* first = std::find_if(low, low + page, [](char byte) { return byte != 0; });
+            peak = static_cast<size_t>(base + length - first);
+        }
+    }
+#endif
+
+    // Return the touched pages; the next run starts from zeroed memory
+    madvise(base, length, MADV_DONTNEED);
+    return peak;
+}
+#else
+StackRunner::StackRunner(size_t stackSize)
+    : stackSize_(stackSize), stack_(nullptr) {
+    throw Exception("StackRunner is not supported on this platform");
+}
+
+StackRunner::~StackRunner() = default;
+
+void StackRunner::runOnStack(Runtime&, const std::function<void()>&) {
+}
+
+size_t StackRunner::measureAndRelease() {
+    return 0;
+}
+#endif
+
+Value StackRunner::eval(Context& ctx, const std::string& code, const std::string& filename) {
+    return run(ctx, [&]() { return ctx.eval(code, filename); });
+}
+
+} // namespace QuickJSWrapper
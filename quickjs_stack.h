@@ -0,0 +1,95 @@
+#pragma once
+
+#include "quickjs_wrapper.h"
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace QuickJSWrapper {
+
+// Runs evaluations on a dedicated thread whose native stack is much larger
+// than a default thread's, so deep recursion costs memory instead of a
+// RangeError. For the duration of a run the runtime's stack top is moved to
+// that thread and its JS stack limit raised to fill the stack (less a guard
+// for native frames); both are restored on the calling thread afterwards.
+//
+// The stack is reserved up front but only committed as it is touched. After
+// each run the touched pages are measured, reported as peak usage, and
+// released again. Runs are serialized; one runner can serve many contexts.
+//
+// Only work run through the runner is measured: the pages of the runner's
+// own stack are the measurement, and a thread's ordinary stack has no such
+// clean baseline. To know the peak stack use of an evaluation, run it here
+// rather than with Context::eval on the calling thread.
+class StackRunner {
+public:
+    static constexpr size_t kDefaultStackSize = 64 * 1024 * 1024;
+    // Kept between the JS stack limit and the end of the stack
+    static constexpr size_t kGuardSize = 256 * 1024;
+
+    explicit StackRunner(size_t stackSize = kDefaultStackSize);
+    ~StackRunner();
+
+    StackRunner(const StackRunner&) = delete;
+    StackRunner& operator=(const StackRunner&) = delete;
+
+    // Calls fn on the large stack and returns its result; exceptions thrown
+    // by fn are rethrown on the calling thread
+    template <typename F>
+    auto run(Context& ctx, F&& fn) -> std::invoke_result_t<F&>;
+
+    Value eval(Context& ctx, const std::string& code, const std::string& filename = "<eval>");
+
+    size_t getStackSize() const { return stackSize_; }
+    // Native stack bytes touched by the most recent run (page granularity)
+    size_t getLastPeakUsage() const { return lastPeakUsage_; }
+    size_t getMaxPeakUsage() const { return maxPeakUsage_; }
+
+private:
+    size_t stackSize_;
+    void* stack_;
+    size_t lastPeakUsage_ = 0;
+    size_t maxPeakUsage_ = 0;
+    std::mutex mutex_;
+
+    void runOnStack(Runtime& runtime, const std::function<void()>& body);
+    size_t measureAndRelease();
+};
+
+template <typename F>
+auto StackRunner::run(Context& ctx, F&& fn) -> std::invoke_result_t<F&> {
+    using Result = std::invoke_result_t<F&>;
+    std::exception_ptr error;
+    if constexpr (std::is_void_v<Result>) {
+        runOnStack(*ctx.getRuntime(), [&]() {
+            try {
+                fn();
+            } catch (...) {
+                error = std::current_exception();
+            }
+        });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    } else {
+        std::optional<Result> result;
+        runOnStack(*ctx.getRuntime(), [&]() {
+            try {
+                result.emplace(fn());
+            } catch (...) {
+                error = std::current_exception();
+            }
+        });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*result);
+    }
+}
+
+} // namespace QuickJSWrapper
@@ -0,0 +1,120 @@
+#include "quickjs_thread_pool.h"
+#include <algorithm>
+
+namespace QuickJSWrapper {
+
+ThreadPool::ThreadPool(ThreadPoolOptions options)
+    : options_(std::move(options)),
+      self_(std::make_shared<std::atomic<ThreadPool*>>(this)) {
+    size_t count = options_.threads;
+    if (count == 0) {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        threads_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    // Bindings a script kept a reference to now fail instead of dangling
+    self_->store(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    spaceAvailable_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+bool ThreadPool::full() const {
+    return options_.maxQueueDepth != 0 && queue_.size() >= options_.maxQueueDepth;
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    queue_.push_back(Task{std::move(task), std::chrono::steady_clock::now()});
+    metrics_.submitted++;
+    metrics_.peakQueueDepth = std::max(metrics_.peakQueueDepth, queue_.size());
+}
+
+bool ThreadPool::trySubmit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            throw Exception("Failed to submit task: thread pool is shutting down");
+        }
+        if (full()) {
+            metrics_.rejected++;
+            return false;
+        }
+        enqueue(std::move(task));
+    }
+    workAvailable_.notify_one();
+    return true;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        spaceAvailable_.wait(lock, [this]() { return stopping_ || !full(); });
+        if (stopping_) {
+            throw Exception("Failed to submit task: thread pool is shutting down");
+        }
+        enqueue(std::move(task));
+    }
+    workAvailable_.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+            metrics_.active++;
+
+            auto waited = std::chrono::steady_clock::now() - task.queuedAt;
+            metrics_.totalQueueWait += waited;
+            metrics_.maxQueueWait = std::max<std::chrono::nanoseconds>(metrics_.maxQueueWait, waited);
+        }
+        spaceAvailable_.notify_one();
+
+        bool ok = true;
+        try {
+            task.run();
+        } catch (...) {
+            ok = false;
+        }
+        // Release captured state before the task counts as completed
+        task.run = nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        metrics_.active--;
+        metrics_.completed++;
+        if (!ok) {
+            metrics_.failed++;
+        }
+    }
+}
+
+size_t ThreadPool::queueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+ThreadPoolMetrics ThreadPool::getMetrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ThreadPoolMetrics metrics = metrics_;
+    metrics.queueDepth = queue_.size();
+    return metrics;
+}
+
+} // namespace QuickJSWrapper
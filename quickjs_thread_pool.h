@@ -0,0 +1,172 @@
+#pragma once
+
+#include "quickjs_event_loop.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace QuickJSWrapper {
+
+struct ThreadPoolOptions {
+    // Number of worker threads; 0 uses std::thread::hardware_concurrency()
+    size_t threads = 0;
+    // Tasks allowed to wait for a worker (0 = unbounded). When the queue is
+    // full trySubmit fails and submit blocks.
+    size_t maxQueueDepth = 1024;
+};
+
+struct ThreadPoolMetrics {
+    size_t submitted = 0;
+    size_t completed = 0;
+    // Tasks that exited with an exception
+    size_t failed = 0;
+    // trySubmit calls refused because the queue was full
+    size_t rejected = 0;
+    size_t queueDepth = 0;
+    size_t peakQueueDepth = 0;
+    // Tasks currently running
+    size_t active = 0;
+    std::chrono::nanoseconds totalQueueWait{0};
+    std::chrono::nanoseconds maxQueueWait{0};
+};
+
+// Bounded pool of plain C++ worker threads for blocking host work (file or
+// database access). Tasks never touch JS values; results go back to the JS
+// thread through an EventLoop, see bindAsyncGlobalFunction.
+class ThreadPool {
+public:
+    explicit ThreadPool(ThreadPoolOptions options = {});
+    // Runs all queued tasks, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queues a task unless the queue is full; returns whether it was queued
+    bool trySubmit(std::function<void()> task);
+    // Queues a task, waiting for room if the queue is full
+    void submit(std::function<void()> task);
+
+    size_t size() const { return threads_.size(); }
+    size_t queueDepth() const;
+    ThreadPoolMetrics getMetrics() const;
+
+private:
+    struct Task {
+        std::function<void()> run;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    ThreadPoolOptions options_;
+    std::vector<std::thread> threads_;
+    mutable std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable spaceAvailable_;
+    std::deque<Task> queue_;
+    bool stopping_ = false;
+    ThreadPoolMetrics metrics_;
+    // Shared with asynchronous bindings, cleared on destruction
+    std::shared_ptr<std::atomic<ThreadPool*>> self_;
+
+    template <typename F>
+    friend void bindAsyncGlobalFunction(EventLoop& loop, ThreadPool& pool, const std::string& name, F&& func);
+
+    bool full() const;
+    void enqueue(std::function<void()> task);
+    void workerLoop();
+};
+
+namespace detail {
+    // Arguments of asynchronous bindings are copied out of JS before the call
+    // leaves the JS thread, so borrowed views become owning strings
+    template <typename T>
+    using AsyncArg = std::conditional_t<std::is_same_v<std::decay_t<T>, std::string_view>,
+                                        std::string, std::decay_t<T>>;
+
+    template <typename... Args, size_t... I>
+    std::tuple<AsyncArg<Args>...> convertAsyncArgs(JSContext* ctx, const std::string& name,
+                                                    const std::vector<Value>& args,
+                                                    std::tuple<Args...>*, std::index_sequence<I...>) {
+        static_assert(!((std::is_same_v<std::decay_t<Args>, Value> ||
+                         std::is_same_v<std::decay_t<Args>, ValueRef>) || ...),
+                      "Asynchronous bindings cannot take Values; they stay on the JS thread");
+        std::tuple<typename Converter<std::decay_t<Args>>::Storage...> storage;
+        bool converted = (Converter<std::decay_t<Args>>::fromJS(
+            ctx, I < args.size() ? args[I].getJSValue() : JS_UNDEFINED, std::get<I>(storage)) && ...);
+        if (!converted) {
+            throwPendingException(ctx, "Invalid arguments for " + name);
+        }
+        return std::tuple<AsyncArg<Args>...>(
+            AsyncArg<Args>(Converter<std::decay_t<Args>>::get(std::get<I>(storage)))...);
+    }
+}
+
+// Binds 'func' as a global function that returns a Promise. Arguments are
+// converted on the JS thread as for bindGlobalFunction, the call runs on
+// 'pool' (concurrently with other calls, so func must be thread-safe) and its
+// result settles the promise on 'loop'. Exceptions reject the promise; so
+// does a full pool queue, which bounds the work a script can have in flight.
+// Calls made after the loop or the pool is destroyed throw instead. Jobs
+// already queued settle through the loop's inbox, so finishing workers never
+// touch either object. The destructions themselves must still be ordered
+// after the binding's last call: the loop and the pool may be destroyed on
+// any thread, but not while the JS thread is inside the function.
+
+template <typename F>
+void bindAsyncGlobalFunction(EventLoop& loop, ThreadPool& pool, const std::string& name, F&& func) {
+    using Traits = detail::FunctionTraits<std::decay_t<F>>;
+    using Result = typename Traits::Result;
+    using Arguments = typename Traits::Arguments;
+
+    auto shared = std::make_shared<std::decay_t<F>>(std::forward<F>(func));
+    std::shared_ptr<std::atomic<EventLoop*>> loopSelf = loop.self_;
+    std::shared_ptr<std::atomic<ThreadPool*>> poolSelf = pool.self_;
+    Context& ctx = loop.context();
+    ctx.setGlobalFunction(name, [loopSelf, poolSelf, name, shared](const std::vector<Value>& args) -> Value {
+        EventLoop* loop = loopSelf->load();
+        if (!loop) {
+            throw Exception("Event loop has been destroyed");
+        }
+        ThreadPool* pool = poolSelf->load();
+        if (!pool) {
+            throw Exception("Thread pool has been destroyed");
+        }
+
+        auto converted = detail::convertAsyncArgs(
+            loop->context().getJSContext(), name, args, static_cast<Arguments*>(nullptr),
+            std::make_index_sequence<std::tuple_size_v<Arguments>>{});
+
+        auto [promise, resolver] = loop->newPromise();
+        bool queued = pool->trySubmit([shared, resolver = resolver, converted = std::move(converted)]() mutable {
+            try {
+                if constexpr (std::is_void_v<Result>) {
+                    std::apply(*shared, std::move(converted));
+                    resolver.resolve();
+                } else {
+                    resolver.resolve(std::apply(*shared, std::move(converted)));
+                }
+            } catch (const std::exception& e) {
+                resolver.reject(e.what());
+            } catch (...) {
+                resolver.reject("Unknown error in asynchronous native function");
+            }
+        });
+        if (!queued) {
+            resolver.reject("Failed to schedule " + name + ": worker queue is full");
+        }
+        return promise;
+    });
+}
+
+} // namespace QuickJSWrapper
@@ -1,27 +1,352 @@
 #include "quickjs_wrapper.h"
+#include <algorithm>
 #include <memory>
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <list>
+#include <optional>
+#include <thread>
 #include <unordered_map>
-#include <map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace QuickJSWrapper {
 
-// Global storage for native function callbacks
-static std::map<int, std::unique_ptr<Context::NativeFunction>> g_native_functions;
-static int g_next_function_id = 1;
+// Converts an exception taken off the context to a message and frees it
+static std::string describeException(JSContext* ctx, JSValue exception) {
+    if (JS_IsNull(exception)) {
+        return "No exception";
+    }
+    
+    const char* str = JS_ToCString(ctx, exception);
+    std::string result = str ? str : "Unknown exception";
+    if (str) {
+        JS_FreeCString(ctx, str);
+    }
+    JS_FreeValue(ctx, exception);
+    
+    return result;
+}
+
+// Takes the pending exception off the context and converts it to a message
+static std::string takeExceptionString(JSContext* ctx) {
+    return describeException(ctx, JS_GetException(ctx));
+}
+
+// Allocation failures throw InternalError("out of memory"), or null when
+// even that error could not be created
+static bool isOutOfMemoryError(JSContext* ctx, JSValueConst exception) {
+    if (!JS_IsObject(exception)) {
+        return JS_IsNull(exception) || JS_IsUninitialized(exception);
+    }
+    if (!JS_IsError(ctx, exception)) {
+        return false;
+    }
+    JSValue message = JS_GetPropertyStr(ctx, exception, "message");
+    if (JS_IsException(message)) {
+        // Reading the message failed for want of memory as well
+        JS_FreeValue(ctx, JS_GetException(ctx));
+        return true;
+    }
+    const char* str = JS_ToCString(ctx, message);
+    bool result = !str || std::strcmp(str, "out of memory") == 0;
+    if (str) {
+        JS_FreeCString(ctx, str);
+    } else {
+        JS_FreeValue(ctx, JS_GetException(ctx));
+    }
+    JS_FreeValue(ctx, message);
+    return result;
+}
+
+// PropertyKey class implementation
+PropertyKey::PropertyKey(JSContext* ctx, const std::string& name)
+    : ctx_(ctx), atom_(JS_NewAtomLen(ctx, name.data(), name.size())) {
+    if (atom_ == JS_ATOM_NULL) {
+        detail::throwPendingException(ctx, "Failed to create property key: " + name);
+    }
+}
+
+PropertyKey::PropertyKey(JSContext* ctx, JSAtom atom)
+    : ctx_(ctx), atom_(JS_DupAtom(ctx, atom)) {
+}
+
+PropertyKey::PropertyKey(const PropertyKey& other)
+    : ctx_(other.ctx_), atom_(JS_DupAtom(other.ctx_, other.atom_)) {
+}
+
+PropertyKey::PropertyKey(PropertyKey&& other) noexcept
+    : ctx_(other.ctx_), atom_(other.atom_) {
+    other.atom_ = JS_ATOM_NULL;
+}
+
+PropertyKey& PropertyKey::operator=(const PropertyKey& other) {
+    if (this != &other) {
+        if (atom_ != JS_ATOM_NULL) {
+            JS_FreeAtom(ctx_, atom_);
+        }
+        ctx_ = other.ctx_;
+        atom_ = JS_DupAtom(other.ctx_, other.atom_);
+    }
+    return *this;
+}
+
+PropertyKey& PropertyKey::operator=(PropertyKey&& other) noexcept {
+    if (this != &other) {
+        if (atom_ != JS_ATOM_NULL) {
+            JS_FreeAtom(ctx_, atom_);
+        }
+        ctx_ = other.ctx_;
+        atom_ = other.atom_;
+        other.atom_ = JS_ATOM_NULL;
+    }
+    return *this;
+}
+
+PropertyKey::~PropertyKey() {
+    if (atom_ != JS_ATOM_NULL) {
+        JS_FreeAtom(ctx_, atom_);
+    }
+}
+
+std::string PropertyKey::toString() const {
+    const char* str = JS_AtomToCString(ctx_, atom_);
+    if (!str) {
+        detail::throwPendingException(ctx_, "Failed to convert property key to string");
+    }
+    std::string result(str);
+    JS_FreeCString(ctx_, str);
+    return result;
+}
+
+#ifdef QUICKJS_WRAPPER_REFCOUNT_STATS
+RefcountStats& detail::refcountStats() {
+    thread_local RefcountStats stats;
+    return stats;
+}
+
+RefcountStats getRefcountStats() {
+    return detail::refcountStats();
+}
+
+void resetRefcountStats() {
+    detail::refcountStats() = RefcountStats{};
+}
+#endif
+
+namespace {
+    Value callFunction(JSContext* ctx, JSValueConst func, JSValueConst thisVal,
+                       int argc, JSValue* argv, const std::string& what) {
+        JSValue result = JS_Call(ctx, func, thisVal, argc, argv);
+        if (JS_IsException(result)) {
+            detail::throwPendingException(ctx, what);
+        }
+        return Value::adopt(ctx, result);
+    }
+
+    template <typename Args>
+    Value callMethodWith(ValueRef target, const PropertyKey& method, const Args& args) {
+        Value func = target.getProperty(method);
+        if (!func.isFunction()) {
+            throw Exception("Property is not a function: " + method.toString());
+        }
+        std::vector<JSValue> jsArgs;
+        jsArgs.reserve(args.size());
+        for (const auto& arg : args) {
+            jsArgs.push_back(arg.getJSValue());
+        }
+        return callFunction(target.getContext(), func.getJSValue(), target.getJSValue(),
+                            static_cast<int>(jsArgs.size()), jsArgs.data(),
+                            "Method call failed: " + method.toString());
+    }
+}
+
+// StringView class implementation
+StringView::StringView(JSContext* ctx, JSValueConst val)
+    : ctx_(ctx), data_(nullptr), size_(0) {
+    data_ = JS_ToCStringLen(ctx_, &size_, val);
+    if (!data_) {
+        detail::throwPendingException(ctx_, "Failed to convert value to string");
+    }
+}
+
+StringView::StringView(StringView&& other) noexcept
+    : ctx_(other.ctx_), data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+StringView& StringView::operator=(StringView&& other) noexcept {
+    if (this != &other) {
+        if (data_) {
+            JS_FreeCString(ctx_, data_);
+        }
+        ctx_ = other.ctx_;
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+StringView::~StringView() {
+    if (data_) {
+        JS_FreeCString(ctx_, data_);
+    }
+}
+
+// ValueRef class implementation
+bool ValueRef::isUndefined() const {
+    return JS_IsUndefined(val_);
+}
+
+bool ValueRef::isNull() const {
+    return JS_IsNull(val_);
+}
+
+bool ValueRef::isBool() const {
+    return JS_IsBool(val_);
+}
+
+bool ValueRef::isNumber() const {
+    return JS_IsNumber(val_);
+}
+
+bool ValueRef::isString() const {
+    return JS_IsString(val_);
+}
+
+bool ValueRef::isObject() const {
+    return JS_IsObject(val_);
+}
+
+bool ValueRef::isFunction() const {
+    return JS_IsFunction(ctx_, val_);
+}
+
+bool ValueRef::isArray() const {
+    return JS_IsArray(val_);
+}
+
+bool ValueRef::isArrayBuffer() const {
+    return JS_IsArrayBuffer(val_);
+}
+
+bool ValueRef::toBool() const {
+    return JS_ToBool(ctx_, val_);
+}
+
+int32_t ValueRef::toInt32() const {
+    int32_t result;
+    if (JS_ToInt32(ctx_, &result, val_) < 0) {
+        detail::throwPendingException(ctx_, "Failed to convert value to int32");
+    }
+    return result;
+}
+
+double ValueRef::toNumber() const {
+    double result;
+    if (JS_ToFloat64(ctx_, &result, val_) < 0) {
+        detail::throwPendingException(ctx_, "Failed to convert value to number");
+    }
+    return result;
+}
+
+std::string ValueRef::toString() const {
+    return std::string(toStringView().view());
+}
+
+StringView ValueRef::toStringView() const {
+    return StringView(ctx_, val_);
+}
+
+Value ValueRef::getProperty(const std::string& name) const {
+    JSValue prop = JS_GetPropertyStr(ctx_, val_, name.c_str());
+    if (JS_IsException(prop)) {
+        detail::throwPendingException(ctx_, "Failed to get property: " + name);
+    }
+    return Value::adopt(ctx_, prop);
+}
+
+Value ValueRef::getProperty(const PropertyKey& key) const {
+    JSValue prop = JS_GetProperty(ctx_, val_, key.getAtom());
+    if (JS_IsException(prop)) {
+        detail::throwPendingException(ctx_, "Failed to get property: " + key.toString());
+    }
+    return Value::adopt(ctx_, prop);
+}
+
+Value ValueRef::getElement(int index) const {
+    JSValue elem = JS_GetPropertyUint32(ctx_, val_, index);
+    if (JS_IsException(elem)) {
+        detail::throwPendingException(ctx_, "Failed to get array element at index: " + std::to_string(index));
+    }
+    return Value::adopt(ctx_, elem);
+}
+
+size_t ValueRef::getArrayLength() const {
+    Value length = getProperty("length");
+    return static_cast<size_t>(length.toInt32());
+}
+
+Value ValueRef::call(std::initializer_list<ValueRef> args) const {
+    std::vector<JSValue> jsArgs;
+    jsArgs.reserve(args.size());
+    for (const auto& arg : args) {
+        jsArgs.push_back(arg.val_);
+    }
+    return callFunction(ctx_, val_, JS_UNDEFINED, static_cast<int>(jsArgs.size()), jsArgs.data(),
+                        "Function call failed");
+}
+
+Value ValueRef::callMethod(const PropertyKey& method, std::initializer_list<ValueRef> args) const {
+    return callMethodWith(*this, method, args);
+}
+
+Value ValueRef::toValue() const {
+    return Value::dup(ctx_, val_);
+}
 
 // Value class implementation
 Value::Value(JSContext* ctx, JSValue val, bool owned) 
     : ctx_(ctx), val_(val), owned_(owned) {
     if (owned_ && !JS_IsUninitialized(val_)) {
-        val_ = JS_DupValue(ctx_, val_);
+        val_ = detail::dupValue(ctx_, val_);
     }
 }
 
+Value::Value(JSContext* ctx, JSValue val, AdoptTag)
+    : ctx_(ctx), val_(val), owned_(true) {
+}
+
+Value Value::adopt(JSContext* ctx, JSValue val) {
+    return Value(ctx, val, AdoptTag{});
+}
+
+Value Value::dup(JSContext* ctx, JSValueConst val) {
+    return Value(ctx, val, true);
+}
+
+JSValue Value::release() {
+    JSValue val = owned_ ? val_ : detail::dupValue(ctx_, val_);
+    owned_ = false;
+    val_ = JS_UNINITIALIZED;
+    return val;
+}
+
 Value::Value(const Value& other) 
-    : ctx_(other.ctx_), val_(JS_DupValue(other.ctx_, other.val_)), owned_(true) {
+    : ctx_(other.ctx_), val_(detail::dupValue(other.ctx_, other.val_)), owned_(true) {
 }
 
 Value::Value(Value&& other) noexcept 
@@ -33,10 +358,10 @@ Value::Value(Value&& other) noexcept
 Value& Value::operator=(const Value& other) {
     if (this != &other) {
         if (owned_ && !JS_IsUninitialized(val_)) {
-            JS_FreeValue(ctx_, val_);
+            detail::freeValue(ctx_, val_);
         }
         ctx_ = other.ctx_;
-        val_ = JS_DupValue(other.ctx_, other.val_);
+        val_ = detail::dupValue(other.ctx_, other.val_);
         owned_ = true;
     }
     return *this;
@@ -45,7 +370,7 @@ Value& Value::operator=(const Value& other) {
 Value& Value::operator=(Value&& other) noexcept {
     if (this != &other) {
         if (owned_ && !JS_IsUninitialized(val_)) {
-            JS_FreeValue(ctx_, val_);
+            detail::freeValue(ctx_, val_);
         }
         ctx_ = other.ctx_;
         val_ = other.val_;
@@ -58,180 +383,730 @@ Value& Value::operator=(Value&& other) noexcept {
 
 Value::~Value() {
     if (owned_ && !JS_IsUninitialized(val_)) {
-        JS_FreeValue(ctx_, val_);
+        detail::freeValue(ctx_, val_);
     }
 }
 
 bool Value::isUndefined() const {
-    return JS_IsUndefined(val_);
+    return ref().isUndefined();
 }
 
 bool Value::isNull() const {
-    return JS_IsNull(val_);
+    return ref().isNull();
 }
 
 bool Value::isBool() const {
-    return JS_IsBool(val_);
+    return ref().isBool();
 }
 
 bool Value::isNumber() const {
-    return JS_IsNumber(val_);
+    return ref().isNumber();
+}
+
+bool Value::isString() const {
+    return ref().isString();
+}
+
+bool Value::isObject() const {
+    return ref().isObject();
+}
+
+bool Value::isFunction() const {
+    return ref().isFunction();
+}
+
+bool Value::isArray() const {
+    return ref().isArray();
+}
+
+bool Value::isArrayBuffer() const {
+    return ref().isArrayBuffer();
+}
+
+uint8_t* Value::viewBytes(size_t& byteLength, int& arrayType) const {
+    size_t byteOffset = 0;
+    JSValue buffer = JS_UNDEFINED;
+    arrayType = JS_GetTypedArrayType(val_);
+    if (arrayType >= 0) {
+        size_t bytesPerElement = 0;
+        buffer = JS_GetTypedArrayBuffer(ctx_, val_, &byteOffset, &byteLength, &bytesPerElement);
+        if (JS_IsException(buffer)) {
+            detail::throwPendingException(ctx_, "Failed to view typed array");
+        }
+    } else if (!JS_IsArrayBuffer(val_)) {
+        throw Exception("Failed to view value: not a typed array or ArrayBuffer");
+    }
+
+    // The typed array holds its buffer, so the data outlives this reference
+    size_t bufferLength = 0;
+    uint8_t* data = JS_GetArrayBuffer(ctx_, &bufferLength, arrayType >= 0 ? buffer : val_);
+    JS_FreeValue(ctx_, buffer);
+    if (!data) {
+        detail::throwPendingException(ctx_, "Failed to view array buffer");
+    }
+    if (arrayType < 0) {
+        byteLength = bufferLength;
+    }
+    return data + byteOffset;
+}
+
+bool Value::toBool() const {
+    return ref().toBool();
+}
+
+int32_t Value::toInt32() const {
+    return ref().toInt32();
+}
+
+double Value::toNumber() const {
+    return ref().toNumber();
+}
+
+std::string Value::toString() const {
+    return ref().toString();
+}
+
+StringView Value::toStringView() const {
+    return ref().toStringView();
+}
+
+Value Value::getProperty(const std::string& name) const {
+    return ref().getProperty(name);
+}
+
+void Value::setProperty(const std::string& name, const Value& value) {
+    if (JS_SetPropertyStr(ctx_, val_, name.c_str(), detail::dupValue(ctx_, value.val_)) < 0) {
+        detail::throwPendingException(ctx_, "Failed to set property: " + name);
+    }
+}
+
+Value Value::getProperty(const PropertyKey& key) const {
+    return ref().getProperty(key);
+}
+
+void Value::setProperty(const PropertyKey& key, const Value& value) {
+    if (JS_SetProperty(ctx_, val_, key.getAtom(), detail::dupValue(ctx_, value.val_)) < 0) {
+        detail::throwPendingException(ctx_, "Failed to set property: " + key.toString());
+    }
+}
+
+Value Value::getElement(int index) const {
+    return ref().getElement(index);
+}
+
+void Value::setElement(int index, const Value& value) {
+    if (JS_SetPropertyUint32(ctx_, val_, index, detail::dupValue(ctx_, value.val_)) < 0) {
+        detail::throwPendingException(ctx_, "Failed to set array element at index: " + std::to_string(index));
+    }
+}
+
+size_t Value::getArrayLength() const {
+    return ref().getArrayLength();
+}
+
+Value Value::call(const std::vector<Value>& args) const {
+    std::vector<JSValue> jsArgs;
+    jsArgs.reserve(args.size());
+    for (const auto& arg : args) {
+        jsArgs.push_back(arg.val_);
+    }
+    return callFunction(ctx_, val_, JS_UNDEFINED, static_cast<int>(jsArgs.size()), jsArgs.data(),
+                        "Function call failed");
+}
+
+Value Value::callMethod(const std::string& method, const std::vector<Value>& args) const {
+    return callMethodWith(ref(), PropertyKey(ctx_, method), args);
+}
+
+Value Value::callMethod(const PropertyKey& method, const std::vector<Value>& args) const {
+    return callMethodWith(ref(), method, args);
+}
+
+// Bytecode cache helpers
+namespace {
+    constexpr char kCacheMagic[8] = {'Q', 'J', 'S', 'W', 'B', 'C', '0', '1'};
+
+    struct CacheHeader {
+        char magic[8];
+        char engineVersion[32];
+        uint64_t sourceHash;
+        uint64_t sourceSize;
+        uint64_t bytecodeSize;
+    };
+
+    uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    void fillEngineVersion(char (&out)[32]) {
+        std::memset(out, 0, sizeof(out));
+        std::strncpy(out, JS_GetVersion(), sizeof(out) - 1);
+    }
+
+    std::string readFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            throw Exception("Failed to open file: " + filename);
+        }
+        
+        std::string content(static_cast<size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        file.read(content.data(), static_cast<std::streamsize>(content.size()));
+        return content;
+    }
+
+    // Read-only view of a cache file, memory-mapped where available
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return;
+            }
+            struct stat st;
+            if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr != MAP_FAILED) {
+                    data_ = static_cast<const uint8_t*>(addr);
+                    size_ = static_cast<size_t>(st.st_size);
+                }
+            }
+            ::close(fd);
+#else
+            std::ifstream file(path, std::ios::binary);
+            if (file.is_open()) {
+                buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+                data_ = reinterpret_cast<const uint8_t*>(buffer_.data());
+                size_ = buffer_.size();
+            }
+#endif
+        }
+
+        ~MappedFile() {
+#ifndef _WIN32
+            if (data_) {
+                ::munmap(const_cast<uint8_t*>(data_), size_);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const uint8_t* data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        const uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+#ifdef _WIN32
+        std::string buffer_;
+#endif
+    };
+
+    std::string cachePathFor(const std::string& directory, const std::string& source,
+                             const std::string& filename) {
+        uint64_t key = fnv1a(JS_GetVersion(), std::strlen(JS_GetVersion()));
+        key = fnv1a(filename.data(), filename.size() + 1, key);
+        key = fnv1a(source.data(), source.size(), key);
+        
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.qjsbc", static_cast<unsigned long long>(key));
+        return (std::filesystem::path(directory) / name).string();
+    }
+
+    std::optional<Script> loadCachedScript(Context& ctx, const std::string& path,
+                                           const std::string& source) {
+        MappedFile file(path);
+        if (!file.data() || file.size() < sizeof(CacheHeader)) {
+            return std::nullopt;
+        }
+        
+        CacheHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        char engineVersion[32];
+        fillEngineVersion(engineVersion);
+        if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+            std::memcmp(header.engineVersion, engineVersion, sizeof(engineVersion)) != 0 ||
+            header.sourceSize != source.size() ||
+            header.sourceHash != fnv1a(source.data(), source.size()) ||
+            header.bytecodeSize != file.size() - sizeof(CacheHeader)) {
+            return std::nullopt;
+        }
+        
+        try {
+            return ctx.loadScript(file.data() + sizeof(CacheHeader), header.bytecodeSize);
+        } catch (const Exception&) {
+            return std::nullopt;
+        }
+    }
+
+    bool storeCachedScript(const std::string& path, const std::string& source,
+                           const Script& script) {
+        std::vector<uint8_t> bytecode = script.serialize();
+        
+        CacheHeader header;
+        std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+        fillEngineVersion(header.engineVersion);
+        header.sourceHash = fnv1a(source.data(), source.size());
+        header.sourceSize = source.size();
+        header.bytecodeSize = bytecode.size();
+        
+        // Write to a unique temporary file and rename it into place so
+        // concurrent workers never observe a partially written entry
+        std::string tempPath = path + ".tmp." +
+            std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "." +
+            std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(bytecode.data()),
+                      static_cast<std::streamsize>(bytecode.size()));
+            if (!out) {
+                out.close();
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+        
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+}
+
+std::vector<uint8_t> Value::serialize() const {
+    size_t size = 0;
+    uint8_t* buffer = JS_WriteObject(ctx_, &size, val_, JS_WRITE_OBJ_REFERENCE);
+    if (!buffer) {
+        detail::throwPendingException(ctx_, "Failed to serialize value");
+    }
+    std::vector<uint8_t> result(buffer, buffer + size);
+    js_free(ctx_, buffer);
+    return result;
+}
+
+// Script class implementation
+Script::Script(JSContext* ctx, JSValue bytecode)
+    : ctx_(ctx), bytecode_(bytecode) {
+}
+
+Script::Script(const Script& other)
+    : ctx_(other.ctx_), bytecode_(JS_DupValue(other.ctx_, other.bytecode_)) {
+}
+
+Script::Script(Script&& other) noexcept
+    : ctx_(other.ctx_), bytecode_(other.bytecode_) {
+    other.bytecode_ = JS_UNINITIALIZED;
+}
+
+Script& Script::operator=(const Script& other) {
+    if (this != &other) {
+        if (!JS_IsUninitialized(bytecode_)) {
+            JS_FreeValue(ctx_, bytecode_);
+        }
+        ctx_ = other.ctx_;
+        bytecode_ = JS_DupValue(other.ctx_, other.bytecode_);
+    }
+    return *this;
+}
+
+Script& Script::operator=(Script&& other) noexcept {
+    if (this != &other) {
+        if (!JS_IsUninitialized(bytecode_)) {
+            JS_FreeValue(ctx_, bytecode_);
+        }
+        ctx_ = other.ctx_;
+        bytecode_ = other.bytecode_;
+        other.bytecode_ = JS_UNINITIALIZED;
+    }
+    return *this;
+}
+
+Script::~Script() {
+    if (!JS_IsUninitialized(bytecode_)) {
+        JS_FreeValue(ctx_, bytecode_);
+    }
+}
+
+Value Script::run() const {
+    if (JS_IsUninitialized(bytecode_)) {
+        throw Exception("Script has been moved from");
+    }
+    
+    // JS_EvalFunction consumes its argument, so hand it a fresh reference
+    // and keep the bytecode for the next run
+    JSValue result = JS_EvalFunction(ctx_, JS_DupValue(ctx_, bytecode_));
+    if (JS_IsException(result)) {
+        detail::throwPendingException(ctx_, "Script evaluation failed");
+    }
+    return Value::adopt(ctx_, result);
+}
+
+std::vector<uint8_t> Script::serialize() const {
+    size_t size = 0;
+    uint8_t* buffer = JS_WriteObject(ctx_, &size, bytecode_, JS_WRITE_OBJ_BYTECODE);
+    if (!buffer) {
+        detail::throwPendingException(ctx_, "Failed to serialize script");
+    }
+    std::vector<uint8_t> result(buffer, buffer + size);
+    js_free(ctx_, buffer);
+    return result;
+}
+
+// Runtime class implementation
+namespace {
+    // Every block handed to QuickJS is prefixed with its requested size, which
+    // malloc_usable_size reports back and the allocator receives on free
+    struct alignas(16) BlockHeader {
+        size_t size;
+    };
+
+    BlockHeader* headerOf(const void* ptr) {
+        return reinterpret_cast<BlockHeader*>(
+            const_cast<char*>(static_cast<const char*>(ptr)) - sizeof(BlockHeader));
+    }
+
+    void recordAllocation(MemoryStats& stats, size_t size) {
+        stats.bytes += size;
+        stats.blocks++;
+        stats.blocksBySize[MemoryStats::sizeClass(size)]++;
+        stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
+    }
+
+    void recordFree(MemoryStats& stats, size_t size) {
+        stats.bytes -= size;
+        stats.blocks--;
+        stats.blocksBySize[MemoryStats::sizeClass(size)]--;
+    }
+
+    // Largest block whose size still fits once the header is added
+    constexpr size_t kMaxBlockSize = SIZE_MAX - sizeof(BlockHeader);
+
+    // Refuses growth past the memory limit, and blocks too large to
+    // represent, and remembers the failure so the resulting JS exception is
+    // reported as OutOfMemoryException
+    bool admit(detail::HeapState& heap, size_t growth, size_t blockSize) {
+        if (blockSize > kMaxBlockSize ||
+            (heap.limit != 0 && growth > heap.limit - std::min(heap.limit, heap.stats.bytes))) {
+            heap.stats.limitHits++;
+            heap.outOfMemory = true;
+            return false;
+        }
+        return true;
+    }
+
+    void* heapMalloc(void* opaque, size_t size) {
+        auto* heap = static_cast<detail::HeapState*>(opaque);
+        if (!admit(*heap, size, size)) {
+            return nullptr;
+        }
+        auto* header = static_cast<BlockHeader*>(heap->allocator->allocate(size + sizeof(BlockHeader)));
+        if (!header) {
+            heap->outOfMemory = true;
+            return nullptr;
+        }
+        header->size = size;
+        recordAllocation(heap->stats, size);
+        return header + 1;
+    }
+
+    void* heapCalloc(void* opaque, size_t count, size_t size) {
+        if (size != 0 && count > SIZE_MAX / size) {
+            // An overflowing product is refused like any oversized block
+            admit(*static_cast<detail::HeapState*>(opaque), SIZE_MAX, SIZE_MAX);
+            return nullptr;
+        }
+        void* ptr = heapMalloc(opaque, count * size);
+        if (ptr) {
+            std::memset(ptr, 0, count * size);
+        }
+        return ptr;
+    }
+
+    void heapFree(void* opaque, void* ptr) {
+        if (ptr) {
+            auto* heap = static_cast<detail::HeapState*>(opaque);
+            BlockHeader* header = headerOf(ptr);
+            recordFree(heap->stats, header->size);
+            heap->allocator->deallocate(header, header->size + sizeof(BlockHeader));
+        }
+    }
+
+    void* heapRealloc(void* opaque, void* ptr, size_t size) {
+        if (!ptr) {
+            return size ? heapMalloc(opaque, size) : nullptr;
+        }
+        if (size == 0) {
+            heapFree(opaque, ptr);
+            return nullptr;
+        }
+        auto* heap = static_cast<detail::HeapState*>(opaque);
+        BlockHeader* header = headerOf(ptr);
+        size_t oldSize = header->size;
+        if (size > oldSize && !admit(*heap, size - oldSize, size)) {
+            return nullptr;
+        }
+        auto* resized = static_cast<BlockHeader*>(heap->allocator->reallocate(
+            header, oldSize + sizeof(BlockHeader), size + sizeof(BlockHeader)));
+        if (!resized) {
+            heap->outOfMemory = true;
+            return nullptr;
+        }
+        resized->size = size;
+        recordFree(heap->stats, oldSize);
+        recordAllocation(heap->stats, size);
+        return resized + 1;
+    }
+
+    size_t heapUsableSize(const void* ptr) {
+        return ptr ? headerOf(ptr)->size : 0;
+    }
+
+    const JSMallocFunctions heapFunctions = {
+        heapCalloc,
+        heapMalloc,
+        heapFree,
+        heapRealloc,
+        heapUsableSize,
+    };
+}
+
+size_t MemoryStats::sizeClass(size_t size) {
+    size_t index = 0;
+    for (size_t limit = 16; size > limit && index + 1 < kSizeClasses; limit <<= 1) {
+        index++;
+    }
+    return index;
+}
+
+Runtime::Runtime() : Runtime(RuntimeOptions{}) {
+}
+
+Runtime::Runtime(std::shared_ptr<Allocator> allocator)
+    : Runtime(RuntimeOptions{std::move(allocator)}) {
+}
+
+Runtime::Runtime(const RuntimeOptions& options)
+    : allocator_(options.allocator ? options.allocator : std::make_shared<MallocAllocator>()),
+      heap_(std::make_unique<detail::HeapState>()),
+      runtime_(nullptr), functionClassId_(0),
+      maxStackSize_(options.maxStackSize ? options.maxStackSize : kDefaultMaxStackSize) {
+    // The hooks are installed even for malloc so the counters always hold
+    heap_->allocator = allocator_.get();
+    runtime_ = JS_NewRuntime2(&heapFunctions, heap_.get());
+    if (!runtime_) {
+        throw Exception("Failed to create JS runtime");
+    }
+    
+    JS_SetRuntimeOpaque(runtime_, this);
+    JS_SetInterruptHandler(runtime_, interruptHandler, this);
+    registerFunctionClass();
+    setMemoryLimit(options.memoryLimit);
+    JS_SetMaxStackSize(runtime_, maxStackSize_);
+    if (options.gcThreshold != 0) {
+        setGCThreshold(options.gcThreshold);
+    }
+}
+
+Runtime::~Runtime() {
+    if (runtime_) {
+        JS_FreeRuntime(runtime_);
+    }
+}
+
+Runtime* Runtime::fromJSRuntime(JSRuntime* rt) {
+    return static_cast<Runtime*>(JS_GetRuntimeOpaque(rt));
 }
 
-bool Value::isString() const {
-    return JS_IsString(val_);
+void Runtime::registerFunctionClass() {
+    // Class IDs are allocated per runtime, so no process-global state is shared
+    // between runtimes on different threads.
+    JS_NewClassID(runtime_, &functionClassId_);
+
+    JSClassDef def{};
+    def.class_name = "NativeFunction";
+    def.finalizer = functionHolderFinalizer;
+    if (JS_NewClass(runtime_, functionClassId_, &def) < 0) {
+        JS_FreeRuntime(runtime_);
+        throw Exception("Failed to register native function class");
+    }
 }
 
-bool Value::isObject() const {
-    return JS_IsObject(val_);
+void Runtime::functionHolderFinalizer(JSRuntime* rt, JSValueConst val) {
+    Runtime* runtime = fromJSRuntime(rt);
+    delete static_cast<detail::FunctionHolder*>(JS_GetOpaque(val, runtime->functionClassId_));
 }
 
-bool Value::isFunction() const {
-    return JS_IsFunction(ctx_, val_);
+int Runtime::interruptHandler(JSRuntime*, void* opaque) {
+    detail::InterruptState& state = static_cast<Runtime*>(opaque)->interrupt_;
+    if (!state.active) {
+        return 0;
+    }
+    if (state.expired) {
+        state.timedOut = true;
+        return 1;
+    }
+
+    state.ticks++;
+    bool expired = state.tickLimit != 0 && state.ticks >= state.tickLimit;
+    if (!expired && state.hasClock && --state.countdown == 0) {
+        state.countdown = state.clockCheckInterval;
+        expired = std::chrono::steady_clock::now() >= state.deadline;
+    }
+    if (expired) {
+        state.expired = true;
+        state.timedOut = true;
+        return 1;
+    }
+    return 0;
 }
 
-bool Value::isArray() const {
-    return JS_IsArray(val_);
+void Runtime::runGC() {
+    JS_RunGC(runtime_);
 }
 
-bool Value::toBool() const {
-    return JS_ToBool(ctx_, val_);
+size_t Runtime::getMemoryUsage() const {
+    return heap_->stats.bytes;
 }
 
-int32_t Value::toInt32() const {
-    int32_t result;
-    if (JS_ToInt32(ctx_, &result, val_) < 0) {
-        throw Exception("Failed to convert value to int32");
-    }
-    return result;
+JSMemoryUsage Runtime::computeMemoryUsage() const {
+    JSMemoryUsage usage;
+    JS_ComputeMemoryUsage(runtime_, &usage);
+    return usage;
 }
 
-double Value::toNumber() const {
-    double result;
-    if (JS_ToFloat64(ctx_, &result, val_) < 0) {
-        throw Exception("Failed to convert value to number");
-    }
-    return result;
+void Runtime::setMemoryLimit(size_t bytes) {
+    // Enforced in the allocation hooks rather than with JS_SetMemoryLimit so
+    // that refusals are counted and recognised when translating exceptions
+    heap_->limit = bytes;
 }
 
-std::string Value::toString() const {
-    const char* str = JS_ToCString(ctx_, val_);
-    if (!str) {
-        throw Exception("Failed to convert value to string");
-    }
-    std::string result(str);
-    JS_FreeCString(ctx_, str);
-    return result;
+void Runtime::setGCThreshold(size_t bytes) {
+    JS_SetGCThreshold(runtime_, bytes);
 }
 
-Value Value::getProperty(const std::string& name) const {
-    JSValue prop = JS_GetPropertyStr(ctx_, val_, name.c_str());
-    if (JS_IsException(prop)) {
-        throw Exception("Failed to get property: " + name);
-    }
-    return Value(ctx_, prop, true);
+size_t Runtime::getGCThreshold() const {
+    return JS_GetGCThreshold(runtime_);
 }
 
-void Value::setProperty(const std::string& name, const Value& value) {
-    if (JS_SetPropertyStr(ctx_, val_, name.c_str(), JS_DupValue(ctx_, value.val_)) < 0) {
-        throw Exception("Failed to set property: " + name);
-    }
+void Runtime::setMaxStackSize(size_t bytes) {
+    maxStackSize_ = bytes;
+    JS_SetMaxStackSize(runtime_, bytes);
 }
 
-Value Value::getElement(int index) const {
-    JSValue elem = JS_GetPropertyUint32(ctx_, val_, index);
-    if (JS_IsException(elem)) {
-        throw Exception("Failed to get array element at index: " + std::to_string(index));
-    }
-    return Value(ctx_, elem, true);
+void Runtime::updateStackTop() {
+    JS_UpdateStackTop(runtime_);
 }
 
-void Value::setElement(int index, const Value& value) {
-    if (JS_SetPropertyUint32(ctx_, val_, index, JS_DupValue(ctx_, value.val_)) < 0) {
-        throw Exception("Failed to set array element at index: " + std::to_string(index));
-    }
+namespace detail {
+    struct StringCache {
+        struct Entry {
+            std::string text;
+            JSValue value;
+        };
+
+        // Most recently used first; keys view the text of their entry, which
+        // list nodes keep at a stable address
+        std::list<Entry> entries;
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+        size_t capacity = Context::kDefaultStringCacheCapacity;
+        StringCacheStats stats;
+
+        void evictTo(JSContext* ctx, size_t size) {
+            while (entries.size() > size) {
+                Entry& last = entries.back();
+                index.erase(last.text);
+                freeValue(ctx, last.value);
+                entries.pop_back();
+                stats.evictions++;
+            }
+        }
+    };
 }
 
-size_t Value::getArrayLength() const {
-    Value length = getProperty("length");
-    return static_cast<size_t>(length.toInt32());
+// Context class implementation
+Context::Context() : Context(std::make_shared<Runtime>()) {
 }
 
-Value Value::call(const std::vector<Value>& args) const {
-    std::vector<JSValue> jsArgs;
-    jsArgs.reserve(args.size());
-    for (const auto& arg : args) {
-        jsArgs.push_back(arg.val_);
-    }
-    
-    JSValue result = JS_Call(ctx_, val_, JS_UNDEFINED, jsArgs.size(), jsArgs.data());
-    if (JS_IsException(result)) {
-        throw Exception("Function call failed");
-    }
-    return Value(ctx_, result, true);
+Context::Context(std::shared_ptr<Allocator> allocator)
+    : Context(std::make_shared<Runtime>(std::move(allocator))) {
 }
 
-Value Value::callMethod(const std::string& method, const std::vector<Value>& args) const {
-    Value methodFunc = getProperty(method);
-    if (!methodFunc.isFunction()) {
-        throw Exception("Property is not a function: " + method);
-    }
-    
-    std::vector<JSValue> jsArgs;
-    jsArgs.reserve(args.size());
-    for (const auto& arg : args) {
-        jsArgs.push_back(arg.val_);
-    }
-    
-    JSValue result = JS_Call(ctx_, methodFunc.val_, val_, jsArgs.size(), jsArgs.data());
-    if (JS_IsException(result)) {
-        throw Exception("Method call failed: " + method);
-    }
-    return Value(ctx_, result, true);
+Context::Context(const RuntimeOptions& options)
+    : Context(std::make_shared<Runtime>(options)) {
 }
 
-// Context class implementation
-Context::Context() : runtime_(nullptr), context_(nullptr) {
-    runtime_ = JS_NewRuntime();
+Context::Context(std::shared_ptr<Runtime> runtime)
+    : runtime_(std::move(runtime)), context_(nullptr),
+      handles_(std::make_unique<detail::HandleArena>()),
+      strings_(std::make_unique<detail::StringCache>()) {
     if (!runtime_) {
-        throw Exception("Failed to create JS runtime");
+        throw Exception("Context requires a runtime");
     }
     
-    context_ = JS_NewContext(runtime_);
+    context_ = JS_NewContext(runtime_->getJSRuntime());
     if (!context_) {
-        JS_FreeRuntime(runtime_);
         throw Exception("Failed to create JS context");
     }
+    JS_SetContextOpaque(context_, this);
 }
 
 Context::~Context() {
+    // The runtime reference is released after the context is freed
     if (context_) {
+        clearStringCache();
+        releaseAllPersistent();
         JS_FreeContext(context_);
     }
-    if (runtime_) {
-        JS_FreeRuntime(runtime_);
-    }
 }
 
 Context::Context(Context&& other) noexcept 
-    : runtime_(other.runtime_), context_(other.context_) {
-    other.runtime_ = nullptr;
+    : runtime_(std::move(other.runtime_)), context_(other.context_),
+      bytecodeCacheDirectory_(std::move(other.bytecodeCacheDirectory_)),
+      bytecodeCacheStats_(other.bytecodeCacheStats_),
+      handles_(std::move(other.handles_)),
+      persistent_(std::move(other.persistent_)),
+      strings_(std::move(other.strings_)) {
     other.context_ = nullptr;
+    if (context_) {
+        JS_SetContextOpaque(context_, this);
+    }
 }
 
 Context& Context::operator=(Context&& other) noexcept {
     if (this != &other) {
         if (context_) {
+            clearStringCache();
+            releaseAllPersistent();
             JS_FreeContext(context_);
         }
-        if (runtime_) {
-            JS_FreeRuntime(runtime_);
-        }
         
-        runtime_ = other.runtime_;
+        runtime_ = std::move(other.runtime_);
         context_ = other.context_;
-        other.runtime_ = nullptr;
+        bytecodeCacheDirectory_ = std::move(other.bytecodeCacheDirectory_);
+        bytecodeCacheStats_ = other.bytecodeCacheStats_;
+        handles_ = std::move(other.handles_);
+        persistent_ = std::move(other.persistent_);
+        other.persistent_ = detail::PersistentTable{};
+        strings_ = std::move(other.strings_);
         other.context_ = nullptr;
+        if (context_) {
+            JS_SetContextOpaque(context_, this);
+        }
     }
     return *this;
 }
@@ -240,65 +1115,259 @@ Value Context::eval(const std::string& code, const std::string& filename) {
     JSValue result = JS_Eval(context_, code.c_str(), code.length(), 
                             filename.c_str(), JS_EVAL_TYPE_GLOBAL);
     if (JS_IsException(result)) {
-        std::string errorMsg = getExceptionString();
-        throw Exception("Script evaluation failed: " + errorMsg);
+        detail::throwPendingException(context_, "Script evaluation failed");
     }
-    return wrapJSValue(result, true);
+    return adopt(result);
 }
 
 Value Context::evalFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw Exception("Failed to open file: " + filename);
+    std::string source = readFile(filename);
+    if (bytecodeCacheDirectory_.empty()) {
+        return eval(source, filename);
+    }
+    
+    std::string cachePath = cachePathFor(bytecodeCacheDirectory_, source, filename);
+    if (std::optional<Script> cached = loadCachedScript(*this, cachePath, source)) {
+        bytecodeCacheStats_.hits++;
+        return cached->run();
     }
     
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return eval(buffer.str(), filename);
+    // Cache miss or stale entry: compile from source and refresh the entry
+    bytecodeCacheStats_.misses++;
+    Script script = compile(source, filename);
+    if (storeCachedScript(cachePath, source, script)) {
+        bytecodeCacheStats_.writes++;
+    }
+    return script.run();
+}
+
+Script Context::compile(const std::string& code, const std::string& filename) {
+    JSValue bytecode = JS_Eval(context_, code.c_str(), code.length(), filename.c_str(),
+                               JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+    if (JS_IsException(bytecode)) {
+        detail::throwPendingException(context_, "Script compilation failed");
+    }
+    return Script(context_, bytecode);
+}
+
+Script Context::loadScript(const uint8_t* bytecode, size_t size) {
+    JSValue obj = JS_ReadObject(context_, bytecode, size, JS_READ_OBJ_BYTECODE);
+    if (JS_IsException(obj)) {
+        detail::throwPendingException(context_, "Failed to load script bytecode");
+    }
+    return Script(context_, obj);
+}
+
+Value Context::evalEmbedded(const EmbeddedScript& script) {
+    return loadScript(script.bytecode, script.size).run();
+}
+
+void Context::setBytecodeCacheDirectory(const std::string& directory) {
+    if (!directory.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec) {
+            throw Exception("Failed to create bytecode cache directory: " + directory);
+        }
+    }
+    bytecodeCacheDirectory_ = directory;
 }
 
 Value Context::newUndefined() {
-    return wrapJSValue(JS_UNDEFINED, false);
+    return adopt(JS_UNDEFINED);
 }
 
 Value Context::newNull() {
-    return wrapJSValue(JS_NULL, false);
+    return adopt(JS_NULL);
 }
 
 Value Context::newBool(bool value) {
-    return wrapJSValue(JS_NewBool(context_, value), true);
+    return adopt(JS_NewBool(context_, value));
 }
 
 Value Context::newNumber(double value) {
-    return wrapJSValue(JS_NewFloat64(context_, value), true);
+    return adopt(JS_NewFloat64(context_, value));
 }
 
 Value Context::newInt32(int32_t value) {
-    return wrapJSValue(JS_NewInt32(context_, value), true);
+    return adopt(JS_NewInt32(context_, value));
+}
+
+Value Context::newString(std::string_view str) {
+    return newString(str.data(), str.size());
+}
+
+Value Context::newString(const char* data, size_t length) {
+    JSValue str = JS_NewStringLen(context_, data, length);
+    if (JS_IsException(str)) {
+        detail::throwPendingException(context_, "Failed to create string");
+    }
+    return adopt(str);
+}
+
+Value Context::newCachedString(std::string_view str) {
+    auto& cache = *strings_;
+    if (cache.capacity == 0) {
+        return newString(str);
+    }
+
+    auto found = cache.index.find(str);
+    if (found != cache.index.end()) {
+        cache.stats.hits++;
+        cache.entries.splice(cache.entries.begin(), cache.entries, found->second);
+        return Value::dup(context_, found->second->value);
+    }
+
+    cache.stats.misses++;
+    Value value = newString(str);
+    cache.entries.push_front({std::string(str), detail::dupValue(context_, value.getJSValue())});
+    cache.index.emplace(cache.entries.front().text, cache.entries.begin());
+    cache.evictTo(context_, cache.capacity);
+    return value;
+}
+
+void Context::setStringCacheCapacity(size_t entries) {
+    strings_->capacity = entries;
+    strings_->evictTo(context_, entries);
+}
+
+void Context::clearStringCache() {
+    if (strings_) {
+        auto evictions = strings_->stats.evictions;
+        strings_->evictTo(context_, 0);
+        strings_->stats.evictions = evictions;
+    }
 }
 
-Value Context::newString(const std::string& str) {
-    return wrapJSValue(JS_NewString(context_, str.c_str()), true);
+StringCacheStats Context::getStringCacheStats() const {
+    StringCacheStats stats = strings_->stats;
+    stats.entries = strings_->entries.size();
+    stats.capacity = strings_->capacity;
+    return stats;
 }
 
 Value Context::newObject() {
-    return wrapJSValue(JS_NewObject(context_), true);
+    return adopt(JS_NewObject(context_));
 }
 
 Value Context::newArray() {
-    return wrapJSValue(JS_NewArray(context_), true);
+    return adopt(JS_NewArray(context_));
 }
 
 Value Context::newArray(const std::vector<Value>& elements) {
     JSValue arr = JS_NewArray(context_);
     for (size_t i = 0; i < elements.size(); ++i) {
-        JS_SetPropertyUint32(context_, arr, i, JS_DupValue(context_, elements[i].getJSValue()));
+        JS_SetPropertyUint32(context_, arr, i, detail::dupValue(context_, elements[i].getJSValue()));
+    }
+    return adopt(arr);
+}
+
+namespace {
+    // Owner of an external ArrayBuffer's memory, passed as the free opaque
+    struct ExternalBuffer {
+        std::function<void()> release;
+        std::vector<uint8_t> bytes;
+    };
+
+    // Stand-in for empty buffers, whose data pointer must not be null (see below)
+    uint8_t emptyBufferByte;
+
+    // QuickJS calls this when the buffer is detached and again, with a null
+    // pointer, when the detached buffer is finalized; only the first call
+    // with data releases it, so the opaque is never touched afterwards
+    void freeExternalBuffer(JSRuntime*, void* opaque, void* ptr) {
+        if (!ptr) {
+            return;
+        }
+        std::unique_ptr<ExternalBuffer> buffer(static_cast<ExternalBuffer*>(opaque));
+        if (buffer->release) {
+            buffer->release();
+        }
+    }
+
+    JSValue newExternalArrayBuffer(JSContext* ctx, uint8_t* data, size_t size,
+                                   std::unique_ptr<ExternalBuffer> owner) {
+        JSValue buffer = JS_NewArrayBuffer(ctx, data ? data : &emptyBufferByte, size,
+                                           freeExternalBuffer, owner.get(), false);
+        if (!JS_IsException(buffer)) {
+            owner.release();
+        } else if (owner->release) {
+            owner->release();
+        }
+        return buffer;
     }
-    return wrapJSValue(arr, true);
+}
+
+Value Context::newArrayBuffer(void* data, size_t size, std::function<void()> release) {
+    auto owner = std::make_unique<ExternalBuffer>();
+    owner->release = std::move(release);
+    JSValue buffer = newExternalArrayBuffer(context_, static_cast<uint8_t*>(data), size, std::move(owner));
+    if (JS_IsException(buffer)) {
+        detail::throwPendingException(context_, "Failed to create array buffer");
+    }
+    return adopt(buffer);
+}
+
+Value Context::newArrayBuffer(std::vector<uint8_t> bytes) {
+    // Moving the vector keeps its storage, so the data pointer stays valid
+    auto owner = std::make_unique<ExternalBuffer>();
+    owner->bytes = std::move(bytes);
+    uint8_t* data = owner->bytes.data();
+    size_t size = owner->bytes.size();
+    JSValue buffer = newExternalArrayBuffer(context_, data, size, std::move(owner));
+    if (JS_IsException(buffer)) {
+        detail::throwPendingException(context_, "Failed to create array buffer");
+    }
+    return adopt(buffer);
+}
+
+Value Context::newArrayBufferCopy(const void* data, size_t size) {
+    JSValue buffer = JS_NewArrayBufferCopy(context_, static_cast<const uint8_t*>(data), size);
+    if (JS_IsException(buffer)) {
+        detail::throwPendingException(context_, "Failed to create array buffer");
+    }
+    return adopt(buffer);
+}
+
+Value Context::newTypedArray(JSTypedArrayEnum type, const Value& buffer,
+                             size_t byteOffset, size_t length) {
+    JSValue args[3] = {
+        buffer.getJSValue(),
+        JS_NewInt64(context_, static_cast<int64_t>(byteOffset)),
+        JS_NewInt64(context_, static_cast<int64_t>(length)),
+    };
+    JSValue array = JS_NewTypedArray(context_, 3, args, type);
+    if (JS_IsException(array)) {
+        detail::throwPendingException(context_, "Failed to create typed array");
+    }
+    return adopt(array);
+}
+
+void Context::detachArrayBuffer(const Value& buffer) {
+    if (!buffer.isArrayBuffer()) {
+        throw Exception("Failed to detach: value is not an ArrayBuffer");
+    }
+    JS_DetachArrayBuffer(context_, buffer.getJSValue());
+}
+
+PropertyKey Context::newPropertyKey(const std::string& name) {
+    return PropertyKey(context_, name);
+}
+
+Value Context::deserialize(const uint8_t* data, size_t size) {
+    JSValue value = JS_ReadObject(context_, data, size, JS_READ_OBJ_REFERENCE);
+    if (JS_IsException(value)) {
+        detail::throwPendingException(context_, "Failed to deserialize value");
+    }
+    return adopt(value);
+}
+
+Value Context::deserialize(const std::vector<uint8_t>& data) {
+    return deserialize(data.data(), data.size());
 }
 
 Value Context::getGlobal() {
-    return wrapJSValue(JS_GetGlobalObject(context_), true);
+    return adopt(JS_GetGlobalObject(context_));
 }
 
 Value Context::getGlobalProperty(const std::string& name) {
@@ -307,29 +1376,64 @@ Value Context::getGlobalProperty(const std::string& name) {
     JS_FreeValue(context_, global);
     
     if (JS_IsException(prop)) {
-        throw Exception("Failed to get global property: " + name);
+        detail::throwPendingException(context_, "Failed to get global property: " + name);
     }
-    return wrapJSValue(prop, true);
+    return adopt(prop);
 }
 
 void Context::setGlobalProperty(const std::string& name, const Value& value) {
     JSValue global = JS_GetGlobalObject(context_);
     int result = JS_SetPropertyStr(context_, global, name.c_str(), 
-                                  JS_DupValue(context_, value.getJSValue()));
+                                  detail::dupValue(context_, value.getJSValue()));
     JS_FreeValue(context_, global);
     
     if (result < 0) {
-        throw Exception("Failed to set global property: " + name);
+        detail::throwPendingException(context_, "Failed to set global property: " + name);
+    }
+}
+
+namespace detail {
+    FunctionHolder* getFunctionHolder(JSContext* ctx, JSValueConst holder) {
+        Runtime* runtime = Runtime::fromJSRuntime(JS_GetRuntime(ctx));
+        return static_cast<FunctionHolder*>(JS_GetOpaque(holder, runtime->functionClassId_));
+    }
+
+    void throwPendingException(JSContext* ctx, const std::string& what) {
+        // The heap flag says an allocation failed since the last report; the
+        // pending exception says whether that failure is what is being thrown,
+        // since JS may have caught it and failed later for another reason.
+        // An allocation failure may leave no error object behind at all.
+        Runtime* runtime = Runtime::fromJSRuntime(JS_GetRuntime(ctx));
+        detail::HeapState& heap = *runtime->heap_;
+        JSValue exception = JS_GetException(ctx);
+        bool outOfMemory = heap.outOfMemory && isOutOfMemoryError(ctx, exception);
+        heap.outOfMemory = false;
+        bool timedOut = runtime->interrupt_.timedOut;
+        runtime->interrupt_.timedOut = false;
+
+        std::string message = what + ": " + describeException(ctx, exception);
+        if (timedOut) {
+            throw TimeoutException(message);
+        }
+        if (outOfMemory) {
+            throw OutOfMemoryException(message);
+        }
+        throw Exception(message);
+    }
+
+    void markTimedOut(JSContext* ctx) {
+        Runtime::fromJSRuntime(JS_GetRuntime(ctx))->interrupt_.timedOut = true;
     }
 }
 
-JSValue nativeFunctionCallback(JSContext* ctx, JSValueConst, 
-                              int argc, JSValueConst* argv, 
-                              int magic) {
+JSValue Context::nativeFunctionCallback(JSContext* ctx, JSValueConst,
+                                        int argc, JSValueConst* argv,
+                                        int, JSValueConst* funcData) {
     try {
-        // Find the native function
-        auto it = g_native_functions.find(magic);
-        if (it == g_native_functions.end()) {
+        // The callable lives in the holder object bound as function data
+        auto* holder = static_cast<detail::CallableHolder<NativeFunction>*>(
+            detail::getFunctionHolder(ctx, funcData[0]));
+        if (!holder) {
             return JS_ThrowInternalError(ctx, "Native function not found");
         }
         
@@ -341,9 +1445,14 @@ JSValue nativeFunctionCallback(JSContext* ctx, JSValueConst,
         }
         
         // Call the native function
-        Value result = (*it->second)(args);
-        return JS_DupValue(ctx, result.getJSValue());
+        Value result = holder->callable(args);
+        return detail::dupValue(ctx, result.getJSValue());
         
+    } catch (const TimeoutException& e) {
+        // The outer evaluation must still report the timeout even if JS
+        // is never polled again before the error unwinds to it
+        detail::markTimedOut(ctx);
+        return JS_ThrowInternalError(ctx, "%s", e.what());
     } catch (const Exception& e) {
         return JS_ThrowInternalError(ctx, "%s", e.what());
     } catch (const std::exception& e) {
@@ -353,17 +1462,40 @@ JSValue nativeFunctionCallback(JSContext* ctx, JSValueConst,
     }
 }
 
-Value Context::newFunction(const std::string& name, NativeFunction func) {
-    // Store the function with a unique ID
-    int functionId = g_next_function_id++;
-    g_native_functions[functionId] = std::make_unique<NativeFunction>(std::move(func));
+Value Context::newFunctionObject(const std::string& name, JSValue func) {
+    if (JS_IsException(func)) {
+        throw Exception("Failed to create native function: " + name);
+    }
     
-    // Create the JS function with the ID as magic number
-    JSValue jsFunc = JS_NewCFunctionMagic(context_, nativeFunctionCallback, 
-                                          name.c_str(), 0, JS_CFUNC_generic_magic, 
-                                          functionId);
+    // Hand our reference over to the wrapper so the function (and its holder)
+    // is released as soon as the last script reference goes away
+    return adopt(func);
+}
+
+Value Context::newHolderFunction(const std::string& name, detail::FunctionHolder* holder,
+                                 JSCFunctionData* callback, int length) {
+    // The holder object owns the callable; the function keeps it alive
+    JSValue holderObj = JS_NewObjectClass(context_, runtime_->functionClassId_);
+    if (JS_IsException(holderObj)) {
+        delete holder;
+        throw Exception("Failed to create native function: " + name);
+    }
+    JS_SetOpaque(holderObj, holder);
     
-    return wrapJSValue(jsFunc, true);
+    JSValue func = JS_NewCFunctionData(context_, callback, length, 0, 1, &holderObj);
+    JS_FreeValue(context_, holderObj);
+    if (!JS_IsException(func)) {
+        JS_DefinePropertyValueStr(context_, func, "name",
+                                  JS_NewString(context_, name.c_str()),
+                                  JS_PROP_CONFIGURABLE);
+    }
+    return newFunctionObject(name, func);
+}
+
+Value Context::newFunction(const std::string& name, NativeFunction func) {
+    return newHolderFunction(name,
+                             new detail::CallableHolder<NativeFunction>(std::move(func)),
+                             nativeFunctionCallback, 0);
 }
 
 void Context::setGlobalFunction(const std::string& name, NativeFunction func) {
@@ -371,28 +1503,92 @@ void Context::setGlobalFunction(const std::string& name, NativeFunction func) {
     setGlobalProperty(name, jsFunc);
 }
 
+PersistentHandle Context::persist(const Value& value) {
+    auto& table = persistent_;
+    uint32_t index;
+    if (table.freeHead != detail::PersistentTable::kNoSlot) {
+        index = table.freeHead;
+        table.freeHead = table.slots[index].nextFree;
+    } else {
+        if (table.slots.size() >= detail::PersistentTable::kNoSlot) {
+            throw Exception("Failed to persist value: handle table is full");
+        }
+        index = static_cast<uint32_t>(table.slots.size());
+        table.slots.emplace_back();
+    }
+
+    auto& slot = table.slots[index];
+    // Generation 0 is reserved for default-constructed handles
+    if (++slot.generation == 0) {
+        slot.generation = 1;
+    }
+    slot.value = detail::dupValue(context_, value.getJSValue());
+    slot.live = true;
+
+    table.stats.created++;
+    table.stats.live++;
+    table.stats.peak = std::max(table.stats.peak, table.stats.live);
+    return PersistentHandle{index, slot.generation};
+}
+
+const detail::PersistentTable::Slot& Context::persistentSlot(PersistentHandle handle) const {
+    if (!isPersistentAlive(handle)) {
+        throw Exception("Failed to get persistent handle: handle is stale or was released");
+    }
+    return persistent_.slots[handle.index];
+}
+
+Value Context::getPersistent(PersistentHandle handle) const {
+    return Value::dup(context_, persistentSlot(handle).value);
+}
+
+ValueRef Context::getPersistentRef(PersistentHandle handle) const {
+    return ValueRef(context_, persistentSlot(handle).value);
+}
+
+bool Context::isPersistentAlive(PersistentHandle handle) const {
+    return handle.index < persistent_.slots.size() &&
+           persistent_.slots[handle.index].live &&
+           persistent_.slots[handle.index].generation == handle.generation;
+}
+
+bool Context::releasePersistent(PersistentHandle handle) {
+    if (!isPersistentAlive(handle)) {
+        return false;
+    }
+    auto& table = persistent_;
+    auto& slot = table.slots[handle.index];
+    JSValue value = slot.value;
+    slot.value = JS_UNDEFINED;
+    slot.live = false;
+    slot.nextFree = table.freeHead;
+    table.freeHead = handle.index;
+    table.stats.live--;
+    table.stats.released++;
+    // Freeing may run finalizers, so the slot is settled first
+    detail::freeValue(context_, value);
+    return true;
+}
+
+void Context::releaseAllPersistent() {
+    auto& slots = persistent_.slots;
+    for (uint32_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].live) {
+            releasePersistent(PersistentHandle{i, slots[i].generation});
+        }
+    }
+}
+
 bool Context::hasException() const {
     return JS_IsException(JS_GetException(context_));
 }
 
 Value Context::getException() {
-    return wrapJSValue(JS_GetException(context_), true);
+    return adopt(JS_GetException(context_));
 }
 
 std::string Context::getExceptionString() {
-    JSValue exception = JS_GetException(context_);
-    if (JS_IsNull(exception)) {
-        return "No exception";
-    }
-    
-    const char* str = JS_ToCString(context_, exception);
-    std::string result = str ? str : "Unknown exception";
-    if (str) {
-        JS_FreeCString(context_, str);
-    }
-    JS_FreeValue(context_, exception);
-    
-    return result;
+    return takeExceptionString(context_);
 }
 
 void Context::throwException(const std::string& message) {
@@ -400,17 +1596,47 @@ void Context::throwException(const std::string& message) {
 }
 
 void Context::runGC() {
-    JS_RunGC(runtime_);
+    runtime_->runGC();
 }
 
 size_t Context::getMemoryUsage() const {
-    JSMemoryUsage usage;
-    JS_ComputeMemoryUsage(runtime_, &usage);
-    return usage.memory_used_size;
+    return runtime_->getMemoryUsage();
+}
+
+const MemoryStats& Context::getMemoryStats() const {
+    return runtime_->getMemoryStats();
+}
+
+JSMemoryUsage Context::computeMemoryUsage() const {
+    return runtime_->computeMemoryUsage();
+}
+
+void Context::setMemoryLimit(size_t bytes) {
+    runtime_->setMemoryLimit(bytes);
+}
+
+size_t Context::getMemoryLimit() const {
+    return runtime_->getMemoryLimit();
+}
+
+void Context::setGCThreshold(size_t bytes) {
+    runtime_->setGCThreshold(bytes);
+}
+
+size_t Context::getGCThreshold() const {
+    return runtime_->getGCThreshold();
+}
+
+void Context::setMaxStackSize(size_t bytes) {
+    runtime_->setMaxStackSize(bytes);
+}
+
+size_t Context::getMaxStackSize() const {
+    return runtime_->getMaxStackSize();
 }
 
-Value Context::wrapJSValue(JSValue val, bool owned) {
-    return Value(context_, val, owned);
+Value Context::adopt(JSValue val) {
+    return Value::adopt(context_, val);
 }
 
 void Context::checkException() const {
@@ -419,6 +1645,104 @@ void Context::checkException() const {
     }
 }
 
+// DeadlineScope implementation
+DeadlineScope::DeadlineScope(Context& ctx, std::chrono::nanoseconds timeout)
+    : DeadlineScope(ctx, Deadline{timeout}) {
+}
+
+DeadlineScope::DeadlineScope(Context& ctx, const Deadline& deadline)
+    : runtime_(ctx.getRuntime()) {
+    detail::InterruptState& state = runtime_->interrupt_;
+    saved_ = state;
+
+    // Tighten, never loosen, an enclosing scope's budget
+    if (deadline.timeout.count() > 0) {
+        auto at = std::chrono::steady_clock::now() + deadline.timeout;
+        if (!state.hasClock || at < state.deadline) {
+            state.deadline = at;
+        }
+        state.hasClock = true;
+    }
+    if (deadline.interruptBudget > 0) {
+        uint64_t limit = state.ticks + deadline.interruptBudget;
+        if (state.tickLimit == 0 || limit < state.tickLimit) {
+            state.tickLimit = limit;
+        }
+    }
+    uint32_t interval = std::max<uint32_t>(1, deadline.clockCheckInterval);
+    state.clockCheckInterval = saved_.active ? std::min(saved_.clockCheckInterval, interval) : interval;
+    state.countdown = state.clockCheckInterval;
+    state.active = state.hasClock || state.tickLimit != 0;
+}
+
+DeadlineScope::~DeadlineScope() {
+    // The tick counter keeps running so enclosing instruction budgets
+    // account for the work done inside this scope
+    detail::InterruptState& state = runtime_->interrupt_;
+    uint64_t ticks = state.ticks;
+    state = saved_;
+    state.ticks = ticks;
+}
+
+bool DeadlineScope::expired() const {
+    const detail::InterruptState& state = runtime_->interrupt_;
+    return state.expired ||
+        (state.hasClock && std::chrono::steady_clock::now() >= state.deadline);
+}
+
+// HandleScope implementation
+HandleScope::HandleScope(Context& ctx)
+    : ctx_(ctx.getJSContext()), arena_(ctx.handles_.get()),
+      mark_(arena_->values.size()), depth_(++arena_->depth) {
+}
+
+HandleScope::~HandleScope() {
+    auto& values = arena_->values;
+    for (size_t i = values.size(); i > mark_; --i) {
+        detail::freeValue(ctx_, values[i - 1]);
+    }
+    // Capacity is kept for the next scope
+    values.resize(mark_);
+    arena_->depth--;
+}
+
+ValueRef HandleScope::keep(Value value) {
+    return adopt(value.release());
+}
+
+ValueRef HandleScope::adopt(JSValue val) {
+    if (depth_ != arena_->depth) {
+        JS_FreeValue(ctx_, val);
+        throw Exception("Failed to keep handle: an inner HandleScope is open");
+    }
+    arena_->values.push_back(val);
+    return ValueRef(ctx_, val);
+}
+
+ValueRef HandleScope::getProperty(ValueRef object, const std::string& name) {
+    JSValue prop = JS_GetPropertyStr(ctx_, object.getJSValue(), name.c_str());
+    if (JS_IsException(prop)) {
+        detail::throwPendingException(ctx_, "Failed to get property: " + name);
+    }
+    return adopt(prop);
+}
+
+ValueRef HandleScope::getProperty(ValueRef object, const PropertyKey& key) {
+    JSValue prop = JS_GetProperty(ctx_, object.getJSValue(), key.getAtom());
+    if (JS_IsException(prop)) {
+        detail::throwPendingException(ctx_, "Failed to get property: " + key.toString());
+    }
+    return adopt(prop);
+}
+
+ValueRef HandleScope::getElement(ValueRef object, uint32_t index) {
+    JSValue elem = JS_GetPropertyUint32(ctx_, object.getJSValue(), index);
+    if (JS_IsException(elem)) {
+        detail::throwPendingException(ctx_, "Failed to get array element at index: " + std::to_string(index));
+    }
+    return adopt(elem);
+}
+
 // Utility functions
 namespace Utils {
     Value undefined(Context& ctx) {
@@ -1,11 +1,19 @@
 #pragma once
 
 #include "quickjs/quickjs.h"
+#include "quickjs_allocator.h"
+#include <array>
+#include <chrono>
 #include <string>
 #include <memory>
 #include <vector>
 #include <functional>
+#include <initializer_list>
 #include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace QuickJSWrapper {
 
@@ -14,14 +22,157 @@ public:
     explicit Exception(const std::string& message) : std::runtime_error(message) {}
 };
 
+// Thrown when evaluation is interrupted by an expired DeadlineScope
+class TimeoutException : public Exception {
+public:
+    explicit TimeoutException(const std::string& message) : Exception(message) {}
+};
+
+// Thrown when an operation fails because the runtime hit its memory limit
+// or the allocator ran out of memory
+class OutOfMemoryException : public Exception {
+public:
+    explicit OutOfMemoryException(const std::string& message) : Exception(message) {}
+};
+
+#ifdef QUICKJS_WRAPPER_REFCOUNT_STATS
+// JS_DupValue/JS_FreeValue calls made by Value on the calling thread. Only
+// built with the QUICKJS_WRAPPER_REFCOUNT_STATS CMake option.
+struct RefcountStats {
+    uint64_t dups = 0;
+    uint64_t frees = 0;
+};
+
+RefcountStats getRefcountStats();
+void resetRefcountStats();
+#endif
+
+namespace detail {
+#ifdef QUICKJS_WRAPPER_REFCOUNT_STATS
+    RefcountStats& refcountStats();
+#endif
+
+    inline JSValue dupValue(JSContext* ctx, JSValueConst val) {
+#ifdef QUICKJS_WRAPPER_REFCOUNT_STATS
+        refcountStats().dups++;
+#endif
+        return JS_DupValue(ctx, val);
+    }
+
+    inline void freeValue(JSContext* ctx, JSValue val) {
+#ifdef QUICKJS_WRAPPER_REFCOUNT_STATS
+        refcountStats().frees++;
+#endif
+        JS_FreeValue(ctx, val);
+    }
+}
+
+// Contiguous view of elements owned elsewhere (std::span is C++20)
+template <typename T>
+class Span {
+public:
+    Span() = default;
+    Span(T* data, size_t size) : data_(data), size_(size) {}
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+    Span(std::vector<U>& values) : data_(values.data()), size_(values.size()) {}
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<const U (*)[], T (*)[]>>>
+    Span(const std::vector<U>& values) : data_(values.data()), size_(values.size()) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](size_t index) const { return data_[index]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+namespace detail {
+    // Typed array kind holding elements of type T
+    template <typename T> struct TypedArrayType;
+    template <> struct TypedArrayType<int8_t> { static constexpr JSTypedArrayEnum value = JS_TYPED_ARRAY_INT8; };
+    template <> struct TypedArrayType<uint8_t> { static constexpr JSTypedArrayEnum value = JS_TYPED_ARRAY_UINT8; };
+    template <> struct TypedArrayType<int16_t> { static constexpr JSTypedArrayEnum value = JS_TYPED_ARRAY_INT16; };
+    template <> struct TypedArrayType<uint16_t> { static constexpr JSTypedArrayEnum value = JS_TYPED_ARRAY_UINT16; };
+    template <> struct TypedArrayType<int32_t> { static constexpr JSTypedArrayEnum value = JS_TYPED_ARRAY_INT32; };
+    template <> struct TypedArrayType<uint32_t> { static constexpr JSTypedArrayEnum value = JS_TYPED_ARRAY_UINT32; };
+    template <> struct TypedArrayType<int64_t> { static constexpr JSTypedArrayEnum value = JS_TYPED_ARRAY_BIG_INT64; };
+    template <> struct TypedArrayType<uint64_t> { static constexpr JSTypedArrayEnum value = JS_TYPED_ARRAY_BIG_UINT64; };
+    template <> struct TypedArrayType<float> { static constexpr JSTypedArrayEnum value = JS_TYPED_ARRAY_FLOAT32; };
+    template <> struct TypedArrayType<double> { static constexpr JSTypedArrayEnum value = JS_TYPED_ARRAY_FLOAT64; };
+}
+
+// Pre-interned property name. Creating the key interns the name once so
+// lookups through it skip the per-access string-to-atom conversion.
+class PropertyKey {
+private:
+    JSContext* ctx_;
+    JSAtom atom_;
+
+public:
+    PropertyKey(JSContext* ctx, const std::string& name);
+    // Duplicates an existing atom reference
+    PropertyKey(JSContext* ctx, JSAtom atom);
+    PropertyKey(const PropertyKey& other);
+    PropertyKey(PropertyKey&& other) noexcept;
+    PropertyKey& operator=(const PropertyKey& other);
+    PropertyKey& operator=(PropertyKey&& other) noexcept;
+    ~PropertyKey();
+
+    std::string toString() const;
+
+    // Raw JSAtom access
+    JSAtom getAtom() const { return atom_; }
+    JSContext* getContext() const { return ctx_; }
+};
+
+// UTF-8 contents of a JS value exposed as a std::string_view without
+// copying. Owns the engine's C string, which is freed on destruction, so the
+// view must not outlive the StringView.
+class StringView {
+private:
+    JSContext* ctx_;
+    const char* data_;
+    size_t size_;
+
+public:
+    // Converts like String(val); throws if the conversion fails
+    StringView(JSContext* ctx, JSValueConst val);
+    StringView(StringView&& other) noexcept;
+    StringView& operator=(StringView&& other) noexcept;
+    StringView(const StringView&) = delete;
+    StringView& operator=(const StringView&) = delete;
+    ~StringView();
+
+    std::string_view view() const { return std::string_view(data_, size_); }
+    operator std::string_view() const { return view(); }
+    // NUL-terminated; embedded NULs are part of size()
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+};
+
+class ValueRef;
+
 class Value {
 private:
     JSContext* ctx_;
     JSValue val_;
     bool owned_;
 
+    struct AdoptTag {};
+    Value(JSContext* ctx, JSValue val, AdoptTag);
+
 public:
+    // Adds a reference when owned; otherwise borrows without ever freeing
     Value(JSContext* ctx, JSValue val, bool owned = true);
+    // Takes over a reference the caller owns, such as a JS_* call result
+    static Value adopt(JSContext* ctx, JSValue val);
+    // Adds a reference to a value the caller keeps owning
+    static Value dup(JSContext* ctx, JSValueConst val);
     Value(const Value& other);
     Value(Value&& other) noexcept;
     Value& operator=(const Value& other);
@@ -37,16 +188,21 @@ public:
     bool isObject() const;
     bool isFunction() const;
     bool isArray() const;
+    bool isArrayBuffer() const;
 
     // Value conversion
     bool toBool() const;
     int32_t toInt32() const;
     double toNumber() const;
     std::string toString() const;
+    // Reads the string without copying it into a std::string
+    StringView toStringView() const;
     
     // Object/Array operations
     Value getProperty(const std::string& name) const;
     void setProperty(const std::string& name, const Value& value);
+    Value getProperty(const PropertyKey& key) const;
+    void setProperty(const PropertyKey& key, const Value& value);
     Value getElement(int index) const;
     void setElement(int index, const Value& value);
     size_t getArrayLength() const;
@@ -54,19 +210,569 @@ public:
     // Function call
     Value call(const std::vector<Value>& args = {}) const;
     Value callMethod(const std::string& method, const std::vector<Value>& args = {}) const;
+    Value callMethod(const PropertyKey& method, const std::vector<Value>& args = {}) const;
+
+    // Structured serialization of plain data (objects, arrays, primitives,
+    // typed arrays); functions cannot be serialized. The result can be read
+    // back with Context::deserialize in any context of the same engine version.
+    std::vector<uint8_t> serialize() const;
+
+    // Direct view of the elements of a typed array of matching element type,
+    // or of an ArrayBuffer's bytes reinterpreted as T. No copy is made: the
+    // view is valid while this value is alive and its buffer is not detached
+    // or resized.
+    template <typename T>
+    Span<T> asSpan() const;
+
+    // Non-owning view of this value
+    ValueRef ref() const;
+    // Gives up this value's reference to the caller, leaving it uninitialized
+    JSValue release();
 
     // Raw JSValue access
     JSValue getJSValue() const { return val_; }
     JSContext* getContext() const { return ctx_; }
+
+private:
+    // Backing bytes of a typed array or ArrayBuffer; arrayType is the typed
+    // array kind, or -1 for a plain ArrayBuffer
+    uint8_t* viewBytes(size_t& byteLength, int& arrayType) const;
 };
 
-class Context {
+// Borrowed view of a JS value: construction, copies and destruction never
+// touch the reference count. Valid only while an owner (a Value, an argument
+// array, a property) keeps the value alive, so use it for arguments and
+// temporaries and convert with toValue() to keep the value longer.
+class ValueRef {
+private:
+    JSContext* ctx_;
+    JSValue val_;
+
+public:
+    ValueRef(JSContext* ctx, JSValueConst val) : ctx_(ctx), val_(val) {}
+    ValueRef(const Value& value) : ctx_(value.getContext()), val_(value.getJSValue()) {}
+
+    bool isUndefined() const;
+    bool isNull() const;
+    bool isBool() const;
+    bool isNumber() const;
+    bool isString() const;
+    bool isObject() const;
+    bool isFunction() const;
+    bool isArray() const;
+    bool isArrayBuffer() const;
+
+    bool toBool() const;
+    int32_t toInt32() const;
+    double toNumber() const;
+    std::string toString() const;
+    StringView toStringView() const;
+
+    Value getProperty(const std::string& name) const;
+    Value getProperty(const PropertyKey& key) const;
+    Value getElement(int index) const;
+    size_t getArrayLength() const;
+
+    Value call(std::initializer_list<ValueRef> args = {}) const;
+    Value callMethod(const PropertyKey& method, std::initializer_list<ValueRef> args = {}) const;
+
+    Value toValue() const;
+
+    JSValueConst getJSValue() const { return val_; }
+    JSContext* getContext() const { return ctx_; }
+};
+
+inline ValueRef Value::ref() const {
+    return ValueRef(ctx_, val_);
+}
+
+// Compiled script bytecode. Compiling once and running many times skips the
+// parse/compile step that Context::eval pays on every call.
+class Script {
+private:
+    JSContext* ctx_;
+    JSValue bytecode_;
+
+public:
+    // Adopts the reference to a compiled function object
+    Script(JSContext* ctx, JSValue bytecode);
+    Script(const Script& other);
+    Script(Script&& other) noexcept;
+    Script& operator=(const Script& other);
+    Script& operator=(Script&& other) noexcept;
+    ~Script();
+
+    Value run() const;
+
+    // Serialized bytecode, loadable with Context::loadScript by the same
+    // engine version
+    std::vector<uint8_t> serialize() const;
+
+    // Raw JSValue access
+    JSValue getJSValue() const { return bytecode_; }
+    JSContext* getContext() const { return ctx_; }
+};
+
+namespace detail {
+    // Base for callables owned by native function objects; deleted by the
+    // NativeFunction class finalizer when the function is collected
+    struct FunctionHolder {
+        virtual ~FunctionHolder() = default;
+    };
+
+    template <typename F>
+    struct CallableHolder : FunctionHolder {
+        explicit CallableHolder(F f) : callable(std::move(f)) {}
+        F callable;
+    };
+
+    FunctionHolder* getFunctionHolder(JSContext* ctx, JSValueConst holder);
+
+    // Re-arms the timeout report of the context's runtime, for native code
+    // that turns a TimeoutException back into a JS error
+    void markTimedOut(JSContext* ctx);
+
+    // Borrowed UTF-8 view of a JS string argument, freed after the call
+    struct CStringArg {
+        JSContext* ctx = nullptr;
+        const char* ptr = nullptr;
+        size_t len = 0;
+
+        CStringArg() = default;
+        CStringArg(const CStringArg&) = delete;
+        CStringArg& operator=(const CStringArg&) = delete;
+        ~CStringArg() {
+            if (ptr) {
+                JS_FreeCString(ctx, ptr);
+            }
+        }
+    };
+
+    struct ValueArg {
+        JSContext* ctx = nullptr;
+        JSValueConst val = JS_UNDEFINED;
+    };
+
+    // Argument/result conversion for typed bindings. fromJS leaves a pending
+    // JS exception and returns false when the conversion fails.
+    template <typename T, typename = void>
+    struct Converter;
+
+    template <>
+    struct Converter<bool> {
+        using Storage = bool;
+        static bool fromJS(JSContext* ctx, JSValueConst val, Storage& out) {
+            int result = JS_ToBool(ctx, val);
+            out = result > 0;
+            return result >= 0;
+        }
+        static bool get(Storage& storage) { return storage; }
+        static JSValue toJS(JSContext* ctx, bool value) { return JS_NewBool(ctx, value); }
+    };
+
+    template <typename T>
+    struct Converter<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+        using Storage = T;
+        static bool fromJS(JSContext* ctx, JSValueConst val, Storage& out) {
+            if constexpr (sizeof(T) <= sizeof(int32_t) && std::is_signed_v<T>) {
+                int32_t result;
+                if (JS_ToInt32(ctx, &result, val) < 0) return false;
+                out = static_cast<T>(result);
+            } else if constexpr (sizeof(T) <= sizeof(uint32_t)) {
+                uint32_t result;
+                if (JS_ToUint32(ctx, &result, val) < 0) return false;
+                out = static_cast<T>(result);
+            } else {
+                int64_t result;
+                if (JS_ToInt64(ctx, &result, val) < 0) return false;
+                out = static_cast<T>(result);
+            }
+            return true;
+        }
+        static T get(Storage& storage) { return storage; }
+        static JSValue toJS(JSContext* ctx, T value) {
+            if constexpr (sizeof(T) <= sizeof(int32_t) && std::is_signed_v<T>) {
+                return JS_NewInt32(ctx, value);
+            } else if constexpr (sizeof(T) <= sizeof(uint32_t)) {
+                return JS_NewUint32(ctx, value);
+            } else {
+                return JS_NewInt64(ctx, static_cast<int64_t>(value));
+            }
+        }
+    };
+
+    template <typename T>
+    struct Converter<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+        using Storage = double;
+        static bool fromJS(JSContext* ctx, JSValueConst val, Storage& out) {
+            return JS_ToFloat64(ctx, &out, val) == 0;
+        }
+        static T get(Storage& storage) { return static_cast<T>(storage); }
+        static JSValue toJS(JSContext* ctx, T value) {
+            return JS_NewFloat64(ctx, static_cast<double>(value));
+        }
+    };
+
+    template <>
+    struct Converter<std::string_view> {
+        using Storage = CStringArg;
+        static bool fromJS(JSContext* ctx, JSValueConst val, Storage& out) {
+            out.ctx = ctx;
+            out.ptr = JS_ToCStringLen(ctx, &out.len, val);
+            return out.ptr != nullptr;
+        }
+        static std::string_view get(Storage& storage) { return {storage.ptr, storage.len}; }
+        static JSValue toJS(JSContext* ctx, std::string_view value) {
+            return JS_NewStringLen(ctx, value.data(), value.size());
+        }
+    };
+
+    template <>
+    struct Converter<std::string> {
+        using Storage = CStringArg;
+        static bool fromJS(JSContext* ctx, JSValueConst val, Storage& out) {
+            return Converter<std::string_view>::fromJS(ctx, val, out);
+        }
+        static std::string get(Storage& storage) { return {storage.ptr, storage.len}; }
+        static JSValue toJS(JSContext* ctx, const std::string& value) {
+            return JS_NewStringLen(ctx, value.data(), value.size());
+        }
+    };
+
+    template <>
+    struct Converter<Value> {
+        using Storage = ValueArg;
+        static bool fromJS(JSContext* ctx, JSValueConst val, Storage& out) {
+            out.ctx = ctx;
+            out.val = val;
+            return true;
+        }
+        static Value get(Storage& storage) { return Value(storage.ctx, storage.val, false); }
+        static JSValue toJS(JSContext* ctx, const Value& value) {
+            return dupValue(ctx, value.getJSValue());
+        }
+    };
+
+    // Borrowed arguments: no reference count traffic at all
+    template <>
+    struct Converter<ValueRef> {
+        using Storage = ValueArg;
+        static bool fromJS(JSContext* ctx, JSValueConst val, Storage& out) {
+            out.ctx = ctx;
+            out.val = val;
+            return true;
+        }
+        static ValueRef get(Storage& storage) { return ValueRef(storage.ctx, storage.val); }
+        static JSValue toJS(JSContext* ctx, ValueRef value) {
+            return dupValue(ctx, value.getJSValue());
+        }
+    };
+
+    // Signature deduction for function pointers and callable objects
+    template <typename F>
+    struct FunctionTraits : FunctionTraits<decltype(&F::operator())> {};
+
+    template <typename R, typename... Args>
+    struct FunctionTraits<R(*)(Args...)> {
+        using Result = R;
+        using Arguments = std::tuple<Args...>;
+        static constexpr int arity = sizeof...(Args);
+    };
+
+    template <typename R, typename... Args>
+    struct FunctionTraits<R(Args...)> : FunctionTraits<R(*)(Args...)> {};
+
+    template <typename C, typename R, typename... Args>
+    struct FunctionTraits<R(C::*)(Args...)> : FunctionTraits<R(*)(Args...)> {};
+
+    template <typename C, typename R, typename... Args>
+    struct FunctionTraits<R(C::*)(Args...) const> : FunctionTraits<R(*)(Args...)> {};
+
+    template <typename F, typename R, typename... Args, size_t... I>
+    JSValue invokeTyped(JSContext* ctx, F& func, JSValueConst* argv,
+                        std::tuple<Args...>*, std::index_sequence<I...>) {
+        // Arguments are converted straight from argv into stack storage
+        std::tuple<typename Converter<std::decay_t<Args>>::Storage...> storage;
+        if (!(Converter<std::decay_t<Args>>::fromJS(ctx, argv[I], std::get<I>(storage)) && ...)) {
+            return JS_EXCEPTION;
+        }
+        try {
+            if constexpr (std::is_void_v<R>) {
+                func(Converter<std::decay_t<Args>>::get(std::get<I>(storage))...);
+                return JS_UNDEFINED;
+            } else {
+                return Converter<std::decay_t<R>>::toJS(
+                    ctx, func(Converter<std::decay_t<Args>>::get(std::get<I>(storage))...));
+            }
+        } catch (const TimeoutException& e) {
+            markTimedOut(ctx);
+            return JS_ThrowInternalError(ctx, "%s", e.what());
+        } catch (const std::exception& e) {
+            return JS_ThrowInternalError(ctx, "%s", e.what());
+        } catch (...) {
+            return JS_ThrowInternalError(ctx, "Unknown error in native function");
+        }
+    }
+
+    template <typename F>
+    JSValue invokeTyped(JSContext* ctx, F& func, JSValueConst* argv) {
+        using Traits = FunctionTraits<F>;
+        using Arguments = typename Traits::Arguments;
+        return invokeTyped<F, typename Traits::Result>(
+            ctx, func, argv, static_cast<Arguments*>(nullptr),
+            std::make_index_sequence<std::tuple_size_v<Arguments>>{});
+    }
+
+    // Trampoline for a function known at compile time: no holder, no data slot
+    template <auto Fn>
+    JSValue staticTrampoline(JSContext* ctx, JSValueConst, int, JSValueConst* argv) {
+        auto func = Fn;
+        return invokeTyped(ctx, func, argv);
+    }
+
+    // Trampoline for stateful callables stored in a holder object
+    template <typename F>
+    JSValue holderTrampoline(JSContext* ctx, JSValueConst, int, JSValueConst* argv,
+                             int, JSValueConst* funcData) {
+        auto* holder = static_cast<CallableHolder<F>*>(getFunctionHolder(ctx, funcData[0]));
+        if (!holder) {
+            return JS_ThrowInternalError(ctx, "Native function not found");
+        }
+        return invokeTyped(ctx, holder->callable, argv);
+    }
+}
+
+// Bytecode compiled at build time by quickjs_wrapper_embed_scripts()
+struct EmbeddedScript {
+    const char* name;
+    const uint8_t* bytecode;
+    size_t size;
+};
+
+struct BytecodeCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t writes = 0;
+};
+
+// Slot in a context's persistent handle table. Plain data, so it can be
+// stored in any C++ structure; once the slot is released the generation no
+// longer matches, so a stale handle fails instead of reaching a reused slot.
+struct PersistentHandle {
+    uint32_t index = 0;
+    // Never 0 for a handle returned by Context::persist
+    uint32_t generation = 0;
+
+    bool operator==(const PersistentHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const PersistentHandle& other) const { return !(*this == other); }
+};
+
+struct StringCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    // Entries dropped to stay within capacity
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t capacity = 0;
+};
+
+struct PersistentHandleStats {
+    // Handles not yet released; a steady climb points at a leak
+    size_t live = 0;
+    size_t peak = 0;
+    size_t created = 0;
+    size_t released = 0;
+};
+
+// Live allocation counters maintained by the runtime's allocation hooks, so
+// reading them is constant time. Sizes are the bytes QuickJS requested.
+struct MemoryStats {
+    // Power-of-two buckets: <=16, <=32, ..., <=1024 bytes, then larger
+    static constexpr size_t kSizeClasses = 8;
+
+    size_t bytes = 0;
+    size_t blocks = 0;
+    size_t peakBytes = 0;
+    std::array<size_t, kSizeClasses> blocksBySize{};
+    // Allocations refused because of the memory limit or because the
+    // requested size cannot be represented
+    size_t limitHits = 0;
+
+    static size_t sizeClass(size_t size);
+};
+
+namespace detail {
+    // State behind the JS_NewRuntime2 opaque pointer
+    struct HeapState {
+        Allocator* allocator;
+        MemoryStats stats;
+        // 0 = unlimited
+        size_t limit = 0;
+        // Set when an allocation fails, consumed by throwPendingException
+        bool outOfMemory = false;
+    };
+
+    // Deadline bookkeeping polled by the runtime's interrupt handler
+    struct InterruptState {
+        bool active = false;
+        // Latched once the deadline passes, so later ticks stop immediately
+        bool expired = false;
+        // Set on expiry, consumed by throwPendingException
+        bool timedOut = false;
+        bool hasClock = false;
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t ticks = 0;
+        uint64_t tickLimit = 0;
+        uint32_t clockCheckInterval = 1;
+        uint32_t countdown = 1;
+    };
+
+    // Values kept alive by the open HandleScopes of a context, laid out
+    // contiguously with the innermost scope's values last
+    struct HandleArena {
+        std::vector<JSValue> values;
+        size_t depth = 0;
+    };
+
+    // LRU cache behind Context::newCachedString
+    struct StringCache;
+
+    // Persistent handle slots; released slots are chained through 'nextFree'
+    // so allocation and release are O(1)
+    struct PersistentTable {
+        struct Slot {
+            JSValue value = JS_UNDEFINED;
+            uint32_t generation = 0;
+            bool live = false;
+            uint32_t nextFree = 0;
+        };
+
+        static constexpr uint32_t kNoSlot = UINT32_MAX;
+        std::vector<Slot> slots;
+        uint32_t freeHead = kNoSlot;
+        PersistentHandleStats stats;
+    };
+
+    // Takes the pending JS exception off the context and throws it as the
+    // matching C++ exception, prefixed with what was being done
+    [[noreturn]] void throwPendingException(JSContext* ctx, const std::string& what);
+}
+
+// Budget for the evaluations inside a DeadlineScope. QuickJS polls the
+// interrupt handler about every 10000 branches or calls ("ticks").
+struct Deadline {
+    // Wall-clock budget (0 = none)
+    std::chrono::nanoseconds timeout{0};
+    // Budget in interrupt ticks (0 = none)
+    uint64_t interruptBudget = 0;
+    // Read the clock on every Nth tick only, trading deadline precision
+    // for a cheaper check
+    uint32_t clockCheckInterval = 4;
+};
+
+struct RuntimeOptions {
+    // Allocation policy; malloc when null
+    std::shared_ptr<Allocator> allocator;
+    // Cap on live bytes across every context of the runtime (0 = unlimited).
+    // Allocations past it fail and surface as OutOfMemoryException.
+    size_t memoryLimit = 0;
+    // Bytes allocated between automatic GC runs (0 = QuickJS default)
+    size_t gcThreshold = 0;
+    // Native stack JS may use before throwing RangeError (0 = default). Must
+    // fit the stack of the thread evaluating; see StackRunner for larger ones.
+    size_t maxStackSize = 0;
+};
+
+// Owns a JSRuntime: the atom table, shape hash, GC state and memory
+// accounting shared by every Context created on it. Contexts hold a
+// shared_ptr to their runtime, so a runtime is freed only after its last
+// context. A runtime and its contexts must be used from one thread at a time.
+class Runtime {
 private:
+    // Declared first so they outlive the JSRuntime allocated from them
+    std::shared_ptr<Allocator> allocator_;
+    std::unique_ptr<detail::HeapState> heap_;
     JSRuntime* runtime_;
+    JSClassID functionClassId_;
+    detail::InterruptState interrupt_;
+    size_t maxStackSize_;
+
+public:
+    // Allocates with malloc
+    Runtime();
+    // Routes every allocation of this runtime through the given allocator
+    // (malloc when null)
+    explicit Runtime(std::shared_ptr<Allocator> allocator);
+    explicit Runtime(const RuntimeOptions& options);
+    ~Runtime();
+
+    // Contexts refer to the runtime by address: no copy or move
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+    Runtime(Runtime&&) = delete;
+    Runtime& operator=(Runtime&&) = delete;
+
+    // Memory management (covers every context on this runtime)
+    void runGC();
+    // Live bytes, read from the allocation counters in constant time
+    size_t getMemoryUsage() const;
+    const MemoryStats& getMemoryStats() const { return heap_->stats; }
+    // Full per-category breakdown; walks the entire heap
+    JSMemoryUsage computeMemoryUsage() const;
+
+    // Limits may be changed at any time; lowering the memory limit below
+    // current usage makes further allocations fail until memory is freed
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit() const { return heap_->limit; }
+    void setGCThreshold(size_t bytes);
+    size_t getGCThreshold() const;
+
+    // The limit is measured from the stack top recorded by updateStackTop(),
+    // which must be called again when evaluation moves to another thread
+    static constexpr size_t kDefaultMaxStackSize = 1024 * 1024;
+    void setMaxStackSize(size_t bytes);
+    size_t getMaxStackSize() const { return maxStackSize_; }
+    void updateStackTop();
+
+    const std::shared_ptr<Allocator>& getAllocator() const { return allocator_; }
+
+    // Raw access
+    JSRuntime* getJSRuntime() const { return runtime_; }
+
+private:
+    friend class Context;
+    friend detail::FunctionHolder* detail::getFunctionHolder(JSContext* ctx, JSValueConst holder);
+    friend void detail::throwPendingException(JSContext* ctx, const std::string& what);
+    friend void detail::markTimedOut(JSContext* ctx);
+    friend class DeadlineScope;
+    static int interruptHandler(JSRuntime* rt, void* opaque);
+    static Runtime* fromJSRuntime(JSRuntime* rt);
+    void registerFunctionClass();
+    static void functionHolderFinalizer(JSRuntime* rt, JSValueConst val);
+};
+
+class Context {
+private:
+    std::shared_ptr<Runtime> runtime_;
     JSContext* context_;
+    std::string bytecodeCacheDirectory_;
+    BytecodeCacheStats bytecodeCacheStats_;
+    // Heap-allocated so open scopes survive a move of the context
+    std::unique_ptr<detail::HandleArena> handles_;
+    detail::PersistentTable persistent_;
+    std::unique_ptr<detail::StringCache> strings_;
 
 public:
+    // Creates a context on a private runtime
     Context();
+    // Creates a lightweight context sharing an existing runtime
+    explicit Context(std::shared_ptr<Runtime> runtime);
+    // Creates a context on a private runtime using the given allocator
+    explicit Context(std::shared_ptr<Allocator> allocator);
+    // Creates a context on a private runtime configured by the options
+    explicit Context(const RuntimeOptions& options);
     ~Context();
 
     // Disable copy constructor and assignment
@@ -80,6 +786,17 @@ public:
     // Script execution
     Value eval(const std::string& code, const std::string& filename = "<eval>");
     Value evalFile(const std::string& filename);
+    Script compile(const std::string& code, const std::string& filename = "<eval>");
+    Script loadScript(const uint8_t* bytecode, size_t size);
+    Value evalEmbedded(const EmbeddedScript& script);
+
+    // Opt-in bytecode cache for evalFile. Compiled files are stored in the
+    // directory keyed by source content, file name and engine version; later
+    // loads map the cache file and skip parsing. The directory must be
+    // trusted: cached bytecode is not validated. An empty path disables it.
+    void setBytecodeCacheDirectory(const std::string& directory);
+    const std::string& getBytecodeCacheDirectory() const { return bytecodeCacheDirectory_; }
+    const BytecodeCacheStats& getBytecodeCacheStats() const { return bytecodeCacheStats_; }
 
     // Value creation
     Value newUndefined();
@@ -87,10 +804,40 @@ public:
     Value newBool(bool value);
     Value newNumber(double value);
     Value newInt32(int32_t value);
-    Value newString(const std::string& str);
+    // Strings are created from an explicit length: embedded NULs are kept
+    // and the data need not be NUL-terminated
+    Value newString(std::string_view str);
+    Value newString(const char* data, size_t length);
+    // Same as newString, but repeated content (field names, status codes) is
+    // served from a per-context LRU cache: a hit returns the JS string made
+    // the first time instead of decoding and allocating it again
+    Value newCachedString(std::string_view str);
     Value newObject();
     Value newArray();
     Value newArray(const std::vector<Value>& elements);
+    PropertyKey newPropertyKey(const std::string& name);
+
+    // ArrayBuffers over memory owned by C++, without copying. 'release' runs
+    // exactly once: when the buffer is detached or collected, or straight away
+    // if creation fails. The memory must stay valid until then.
+    Value newArrayBuffer(void* data, size_t size, std::function<void()> release);
+    // Takes over the vector's storage
+    Value newArrayBuffer(std::vector<uint8_t> bytes);
+    Value newArrayBufferCopy(const void* data, size_t size);
+    // Typed array view of 'length' elements over an ArrayBuffer
+    Value newTypedArray(JSTypedArrayEnum type, const Value& buffer, size_t byteOffset, size_t length);
+    // Cuts JS off from an ArrayBuffer before C++ reclaims its memory: views
+    // see length 0 and an external buffer's release runs now
+    void detachArrayBuffer(const Value& buffer);
+    // Typed array holding a copy of 'values', made with a single memcpy
+    template <typename T>
+    Value newTypedArray(Span<const T> values);
+    // Typed array over the vector's storage; moving the vector in avoids any copy
+    template <typename T>
+    Value newTypedArray(std::vector<T> values);
+
+    Value deserialize(const uint8_t* data, size_t size);
+    Value deserialize(const std::vector<uint8_t>& data);
 
     // Global object access
     Value getGlobal();
@@ -102,23 +849,131 @@ public:
     Value newFunction(const std::string& name, NativeFunction func);
     void setGlobalFunction(const std::string& name, NativeFunction func);
 
+    // Typed function binding: arguments are converted directly from the JS
+    // argument list and the declared arity matches the C++ signature.
+    // The first form binds a function known at compile time and allocates
+    // nothing; the second stores a callable object (e.g. a capturing lambda).
+    template <auto Fn>
+    Value bindFunction(const std::string& name);
+    template <typename F>
+    Value bindFunction(const std::string& name, F&& func);
+    template <auto Fn>
+    void bindGlobalFunction(const std::string& name);
+    template <typename F>
+    void bindGlobalFunction(const std::string& name, F&& func);
+
+    // Persistent handles for references C++ keeps for a long time, such as
+    // registered callbacks. Each handle holds one reference until released
+    // or until the context is destroyed.
+    PersistentHandle persist(const Value& value);
+    // Throws for a released or foreign handle
+    Value getPersistent(PersistentHandle handle) const;
+    // Borrowed view, valid until the handle is released
+    ValueRef getPersistentRef(PersistentHandle handle) const;
+    bool isPersistentAlive(PersistentHandle handle) const;
+    // Returns false if the handle was already released
+    bool releasePersistent(PersistentHandle handle);
+    void releaseAllPersistent();
+    const PersistentHandleStats& getPersistentHandleStats() const { return persistent_.stats; }
+
+    // Cached string bound in entries; 0 disables the cache. Shrinking
+    // evicts the least recently used strings.
+    static constexpr size_t kDefaultStringCacheCapacity = 512;
+    void setStringCacheCapacity(size_t entries);
+    void clearStringCache();
+    StringCacheStats getStringCacheStats() const;
+
     // Error handling
     bool hasException() const;
     Value getException();
     std::string getExceptionString();
     void throwException(const std::string& message);
 
-    // Memory management
+    // Memory management (runtime-wide when the runtime is shared)
     void runGC();
     size_t getMemoryUsage() const;
+    const MemoryStats& getMemoryStats() const;
+    JSMemoryUsage computeMemoryUsage() const;
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit() const;
+    void setGCThreshold(size_t bytes);
+    size_t getGCThreshold() const;
+    void setMaxStackSize(size_t bytes);
+    size_t getMaxStackSize() const;
 
     // Raw access
+    const std::shared_ptr<Runtime>& getRuntime() const { return runtime_; }
     JSContext* getJSContext() const { return context_; }
-    JSRuntime* getJSRuntime() const { return runtime_; }
+    JSRuntime* getJSRuntime() const { return runtime_ ? runtime_->getJSRuntime() : nullptr; }
 
 private:
-    Value wrapJSValue(JSValue val, bool owned = true);
+    friend class HandleScope;
+    Value adopt(JSValue val);
     void checkException() const;
+    const detail::PersistentTable::Slot& persistentSlot(PersistentHandle handle) const;
+
+    // Native functions keep their callable in a hidden holder object bound as
+    // function data, so dispatch is a single opaque lookup and the callable is
+    // released by the finalizer when the function is collected.
+    Value newFunctionObject(const std::string& name, JSValue func);
+    Value newHolderFunction(const std::string& name, detail::FunctionHolder* holder,
+                            JSCFunctionData* callback, int length);
+    static JSValue nativeFunctionCallback(JSContext* ctx, JSValueConst thisVal,
+                                          int argc, JSValueConst* argv,
+                                          int magic, JSValueConst* funcData);
+};
+
+// Bounds every evaluation on the context's runtime while in scope: once the
+// deadline passes, running JS is interrupted with an uncatchable error and
+// the failing call throws TimeoutException. Scopes nest, with the tighter
+// budget winning. The context remains usable after the scope ends.
+class DeadlineScope {
+public:
+    DeadlineScope(Context& ctx, const Deadline& deadline);
+    DeadlineScope(Context& ctx, std::chrono::nanoseconds timeout);
+    ~DeadlineScope();
+
+    DeadlineScope(const DeadlineScope&) = delete;
+    DeadlineScope& operator=(const DeadlineScope&) = delete;
+
+    bool expired() const;
+
+private:
+    std::shared_ptr<Runtime> runtime_;
+    detail::InterruptState saved_;
+};
+
+// Keeps the temporaries of a traversal in the context's handle arena instead
+// of in individual Values: each handle is a ValueRef into one contiguous
+// array, and every reference taken in the scope is freed in a single pass
+// when it closes. Scopes nest and must close in reverse order; only the
+// innermost open scope may take new handles.
+class HandleScope {
+public:
+    explicit HandleScope(Context& ctx);
+    ~HandleScope();
+
+    HandleScope(const HandleScope&) = delete;
+    HandleScope& operator=(const HandleScope&) = delete;
+
+    // Moves the value's reference into the scope
+    ValueRef keep(Value value);
+    // Takes over a reference the caller owns, such as a JS_* call result
+    ValueRef adopt(JSValue val);
+
+    // Reads whose results live until the scope closes
+    ValueRef getProperty(ValueRef object, const std::string& name);
+    ValueRef getProperty(ValueRef object, const PropertyKey& key);
+    ValueRef getElement(ValueRef object, uint32_t index);
+
+    // Handles taken by this scope
+    size_t size() const { return arena_->values.size() - mark_; }
+
+private:
+    JSContext* ctx_;
+    detail::HandleArena* arena_;
+    size_t mark_;
+    size_t depth_;
 };
 
 // Utility functions for easy value creation
@@ -134,4 +989,64 @@ namespace Utils {
     Value array(Context& ctx, const std::vector<Value>& elements);
 }
 
+// Typed array templates
+template <typename T>
+Span<T> Value::asSpan() const {
+    using Element = std::remove_const_t<T>;
+    size_t byteLength = 0;
+    int arrayType = -1;
+    uint8_t* bytes = viewBytes(byteLength, arrayType);
+
+    bool matches = arrayType == detail::TypedArrayType<Element>::value ||
+                   (std::is_same_v<Element, uint8_t> && arrayType == JS_TYPED_ARRAY_UINT8C);
+    if (arrayType >= 0 && !matches) {
+        throw Exception("Failed to view typed array: element type does not match");
+    }
+    if (byteLength % sizeof(T) != 0 || reinterpret_cast<uintptr_t>(bytes) % alignof(T) != 0) {
+        throw Exception("Failed to view array buffer: size or alignment does not fit the element type");
+    }
+    return Span<T>(reinterpret_cast<T*>(bytes), byteLength / sizeof(T));
+}
+
+template <typename T>
+Value Context::newTypedArray(Span<const T> values) {
+    Value buffer = newArrayBufferCopy(values.data(), values.size() * sizeof(T));
+    return newTypedArray(detail::TypedArrayType<std::remove_const_t<T>>::value, buffer, 0, values.size());
+}
+
+template <typename T>
+Value Context::newTypedArray(std::vector<T> values) {
+    auto owned = std::make_shared<std::vector<T>>(std::move(values));
+    Value buffer = newArrayBuffer(owned->data(), owned->size() * sizeof(T), [owned]() {});
+    return newTypedArray(detail::TypedArrayType<T>::value, buffer, 0, owned->size());
+}
+
+// Typed binding templates
+template <auto Fn>
+Value Context::bindFunction(const std::string& name) {
+    using Traits = detail::FunctionTraits<std::remove_pointer_t<decltype(Fn)>>;
+    JSValue func = JS_NewCFunction(context_, detail::staticTrampoline<Fn>,
+                                   name.c_str(), Traits::arity);
+    return newFunctionObject(name, func);
+}
+
+template <typename F>
+Value Context::bindFunction(const std::string& name, F&& func) {
+    using Callable = std::decay_t<F>;
+    using Traits = detail::FunctionTraits<Callable>;
+    return newHolderFunction(name,
+                             new detail::CallableHolder<Callable>(std::forward<F>(func)),
+                             detail::holderTrampoline<Callable>, Traits::arity);
+}
+
+template <auto Fn>
+void Context::bindGlobalFunction(const std::string& name) {
+    setGlobalProperty(name, bindFunction<Fn>(name));
+}
+
+template <typename F>
+void Context::bindGlobalFunction(const std::string& name, F&& func) {
+    setGlobalProperty(name, bindFunction(name, std::forward<F>(func)));
+}
+
 } // namespace QuickJSWrapper
\ No newline at end of file
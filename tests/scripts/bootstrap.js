@@ -0,0 +1,7 @@
+// Bootstrap script embedded as bytecode by quickjs_wrapper_embed_scripts
+var bootstrap = {
+    version: 3,
+    greet: function(name) {
+        return 'hello, ' + name;
+    }
+};
@@ -0,0 +1,7 @@
+// Depends on bootstrap.js having run first
+var routes = {
+    '/greet': function(query) {
+        return bootstrap.greet(query);
+    }
+};
+Object.keys(routes).length;
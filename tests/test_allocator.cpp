@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+namespace {
+    // Forwards to malloc and tracks outstanding blocks and bytes
+    class CountingAllocator : public Allocator {
+    public:
+        size_t liveBlocks = 0;
+        size_t liveBytes = 0;
+        size_t allocations = 0;
+
+        void* allocate(size_t size) override {
+            allocations++;
+            liveBlocks++;
+            liveBytes += size;
+            return std::malloc(size);
+        }
+
+        void deallocate(void* ptr, size_t size) override {
+            liveBlocks--;
+            liveBytes -= size;
+            std::free(ptr);
+        }
+    };
+
+    const char* kChurnScript = R"(
+        var kept = [];
+        for (var i = 0; i < 5000; i++) {
+            var obj = { id: i, label: 'item_' + i, values: [i, i + 1, i + 2] };
+            if (i % 10 === 0) kept.push(obj);
+        }
+        var text = '';
+        for (var j = 0; j < 200; j++) text += 'chunk' + j;
+        kept.length + ':' + text.length;
+    )";
+}
+
+// Tests validating custom allocators installed on a runtime
+class AllocatorTest : public Test {
+};
+
+// Validates that every runtime allocation goes through the allocator and is returned
+TEST_F(AllocatorTest, CustomAllocatorSeesEveryBlock) {
+    auto allocator = std::make_shared<CountingAllocator>();
+    {
+        Context ctx(allocator);
+        EXPECT_EQ(ctx.getRuntime()->getAllocator(), allocator);
+        EXPECT_EQ(ctx.eval(kChurnScript).toString(), "500:1490");
+        EXPECT_GT(allocator->liveBlocks, 0u);
+    }
+    EXPECT_GT(allocator->allocations, 1000u);
+    EXPECT_EQ(allocator->liveBlocks, 0u);
+    EXPECT_EQ(allocator->liveBytes, 0u);
+}
+
+// Validates that scripts run unchanged on the size-class pool
+TEST_F(AllocatorTest, PoolAllocatorRunsScripts) {
+    auto pool = PoolAllocator::forCurrentThread();
+    EXPECT_EQ(pool, PoolAllocator::forCurrentThread());
+
+    for (int round = 0; round < 3; ++round) {
+        Context ctx(pool);
+        EXPECT_EQ(ctx.eval(kChurnScript).toString(), "500:1490");
+        ctx.runGC();
+    }
+
+    // Freed blocks are reused, so later rounds reserve no new chunks
+    size_t reserved = pool->getReservedBytes();
+    {
+        Context ctx(pool);
+        ctx.eval(kChurnScript);
+    }
+    EXPECT_EQ(pool->getReservedBytes(), reserved);
+}
+
+// Validates that an arena is reclaimed wholesale once its runtime is gone
+TEST_F(AllocatorTest, ArenaResetAfterRuntimeDestroyed) {
+    auto arena = std::make_shared<ArenaAllocator>();
+    size_t reserved = 0;
+
+    for (int request = 0; request < 3; ++request) {
+        {
+            Context ctx(arena);
+            EXPECT_EQ(ctx.eval(kChurnScript).toString(), "500:1490");
+            EXPECT_THROW(arena->reset(), Exception);
+        }
+        EXPECT_EQ(arena->getLiveBlocks(), 0u);
+        EXPECT_GT(arena->getUsedBytes(), 0u);
+        arena->reset();
+        EXPECT_EQ(arena->getUsedBytes(), 0u);
+
+        // Chunks are kept for the next request
+        if (request == 0) {
+            reserved = arena->getReservedBytes();
+        } else {
+            EXPECT_EQ(arena->getReservedBytes(), reserved);
+        }
+    }
+}
+
+// Validates that several contexts can share one allocator through a runtime
+TEST_F(AllocatorTest, SharedRuntimeWithAllocator) {
+    auto runtime = std::make_shared<Runtime>(std::make_shared<PoolAllocator>());
+    Context first(runtime);
+    Context second(runtime);
+    first.eval("var a = 'first'");
+    second.eval("var a = 'second'");
+    EXPECT_EQ(first.eval("a").toString(), "first");
+    EXPECT_EQ(second.eval("a").toString(), "second");
+}
+
+// Validates that the constant-time counters agree with what the allocator saw
+TEST_F(AllocatorTest, MemoryStatsMatchAllocator) {
+    auto allocator = std::make_shared<CountingAllocator>();
+    Context ctx(allocator);
+    ctx.eval(kChurnScript);
+
+    const MemoryStats& stats = ctx.getMemoryStats();
+    EXPECT_EQ(stats.blocks, allocator->liveBlocks);
+    // The allocator also sees the per-block size header
+    EXPECT_EQ(stats.bytes, allocator->liveBytes - allocator->liveBlocks * 16);
+    EXPECT_EQ(ctx.getMemoryUsage(), stats.bytes);
+
+    size_t classified = 0;
+    for (size_t count : stats.blocksBySize) {
+        classified += count;
+    }
+    EXPECT_EQ(classified, stats.blocks);
+
+    // Dropping the retained objects lowers the live count but not the peak
+    size_t before = stats.bytes;
+    ctx.eval("kept = null; text = null;");
+    ctx.runGC();
+    EXPECT_LT(ctx.getMemoryStats().bytes, before);
+    EXPECT_GE(ctx.getMemoryStats().peakBytes, before);
+
+    // The heap walk is still available separately
+    JSMemoryUsage usage = ctx.computeMemoryUsage();
+    EXPECT_GT(usage.obj_count, 0);
+}
+
+// Validates that sizes that cannot be represented are refused like limit hits
+TEST_F(AllocatorTest, OversizedRequestsRefused) {
+    auto allocator = std::make_shared<CountingAllocator>();
+    Runtime runtime(allocator);
+    JSRuntime* rt = runtime.getJSRuntime();
+    size_t allocations = allocator->allocations;
+    auto limitHits = [&runtime]() { return runtime.getMemoryStats().limitHits; };
+
+    // quickjs-ng may refuse an overflowing product before calling the hook
+    size_t hits = limitHits();
+    EXPECT_EQ(js_calloc_rt(rt, SIZE_MAX / 2, 4), nullptr);
+    EXPECT_LE(limitHits() - hits, 1u);
+
+    // Sizes that pass the engine's checks but leave no room for the header
+    hits = limitHits();
+    EXPECT_EQ(js_calloc_rt(rt, 1, SIZE_MAX - 8), nullptr);
+    EXPECT_EQ(limitHits() - hits, 1u);
+
+    hits = limitHits();
+    EXPECT_EQ(js_malloc_rt(rt, SIZE_MAX - 8), nullptr);
+    EXPECT_EQ(limitHits() - hits, 1u);
+    EXPECT_EQ(allocator->allocations, allocations);
+
+    void* zeroed = js_calloc_rt(rt, 4, 8);
+    ASSERT_NE(zeroed, nullptr);
+    EXPECT_EQ(static_cast<const char*>(zeroed)[31], 0);
+    js_free_rt(rt, zeroed);
+}
+
+// Validates the size class boundaries
+TEST_F(AllocatorTest, MemoryStatsSizeClasses) {
+    EXPECT_EQ(MemoryStats::sizeClass(1), 0u);
+    EXPECT_EQ(MemoryStats::sizeClass(16), 0u);
+    EXPECT_EQ(MemoryStats::sizeClass(17), 1u);
+    EXPECT_EQ(MemoryStats::sizeClass(1024), 6u);
+    EXPECT_EQ(MemoryStats::sizeClass(1025), 7u);
+    EXPECT_EQ(MemoryStats::sizeClass(1 << 20), 7u);
+}
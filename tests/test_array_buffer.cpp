@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating ArrayBuffers over C++ memory
+class ArrayBufferTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+    }
+
+    void TearDown() override {
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+};
+
+// Validates that JS and C++ share the memory and release runs once it is collected
+TEST_F(ArrayBufferTest, ExternalMemorySharedWithoutCopy) {
+    std::vector<uint8_t> storage(1024, 0);
+    int released = 0;
+
+    auto buffer = ctx->newArrayBuffer(storage.data(), storage.size(), [&released]() { released++; });
+    EXPECT_TRUE(buffer.isArrayBuffer());
+    ctx->setGlobalProperty("shared", buffer);
+
+    ctx->eval("var bytes = new Uint8Array(shared); bytes[0] = 42;");
+    EXPECT_EQ(storage[0], 42);
+    storage[1] = 7;
+    EXPECT_EQ(ctx->eval("bytes[1]").toInt32(), 7);
+    EXPECT_EQ(ctx->eval("shared.byteLength").toInt32(), 1024);
+
+    ctx->eval("delete globalThis.shared; bytes = null;");
+    buffer = ctx->newUndefined();
+    ctx->runGC();
+    EXPECT_EQ(released, 1);
+
+    // Buffers still alive are released with their context
+    int releasedWithContext = 0;
+    {
+        Context local;
+        local.setGlobalProperty("kept", local.newArrayBuffer(storage.data(), 16, [&]() { releasedWithContext++; }));
+    }
+    EXPECT_EQ(releasedWithContext, 1);
+}
+
+// Validates that a vector handed over keeps its storage and contents
+TEST_F(ArrayBufferTest, VectorOwnershipTransfer) {
+    std::vector<uint8_t> bytes(256);
+    std::iota(bytes.begin(), bytes.end(), 0);
+
+    ctx->setGlobalProperty("owned", ctx->newArrayBuffer(std::move(bytes)));
+    EXPECT_EQ(ctx->eval("new Uint8Array(owned).reduce(function (a, b) { return a + b; }, 0)").toInt32(),
+              255 * 256 / 2);
+
+    // The copying variant leaves the source untouched
+    std::vector<uint8_t> source(8, 1);
+    ctx->setGlobalProperty("copied", ctx->newArrayBufferCopy(source.data(), source.size()));
+    ctx->eval("new Uint8Array(copied)[0] = 9;");
+    EXPECT_EQ(source[0], 1);
+
+    auto empty = ctx->newArrayBuffer(std::vector<uint8_t>());
+    EXPECT_TRUE(empty.isArrayBuffer());
+}
+
+// Validates typed array views and detaching before C++ reclaims the memory
+TEST_F(ArrayBufferTest, DetachBeforeReclaim) {
+    auto* samples = new double[8];
+    for (int i = 0; i < 8; ++i) {
+        samples[i] = i * 0.5;
+    }
+    int released = 0;
+
+    auto buffer = ctx->newArrayBuffer(samples, 8 * sizeof(double), [&released, samples]() {
+        released++;
+        delete[] samples;
+    });
+    auto view = ctx->newTypedArray(JS_TYPED_ARRAY_FLOAT64, buffer, 2 * sizeof(double), 4);
+    ctx->setGlobalProperty("view", view);
+    EXPECT_EQ(ctx->eval("view.length").toInt32(), 4);
+    EXPECT_DOUBLE_EQ(ctx->eval("view[0] + view[3]").toNumber(), 1.0 + 2.5);
+
+    ctx->detachArrayBuffer(buffer);
+    EXPECT_EQ(released, 1);
+    EXPECT_EQ(ctx->eval("view.length").toInt32(), 0);
+    EXPECT_TRUE(ctx->eval("view[0] === undefined").toBool());
+
+    // Detaching again and collecting the detached buffer do not release twice
+    ctx->detachArrayBuffer(buffer);
+    buffer = ctx->newUndefined();
+    view = ctx->newUndefined();
+    ctx->eval("view = null;");
+    ctx->runGC();
+    EXPECT_EQ(released, 1);
+
+    EXPECT_THROW(ctx->detachArrayBuffer(ctx->newObject()), Exception);
+}
+
+// Validates that a large buffer is handed over in constant time
+TEST_F(ArrayBufferTest, LargeBufferHandoff) {
+    const size_t size = 50 * 1024 * 1024;
+    std::vector<uint8_t> payload(size, 1);
+    payload.back() = 200;
+
+    auto start = std::chrono::steady_clock::now();
+    ctx->setGlobalProperty("payload", ctx->newArrayBuffer(std::move(payload)));
+    auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(ctx->eval("new Uint8Array(payload)[payload.byteLength - 1]").toInt32(), 200);
+    EXPECT_DOUBLE_EQ(ctx->eval("payload.byteLength").toNumber(), static_cast<double>(size));
+    std::cout << "50 MB ArrayBuffer handed to JS in " << elapsedUs << " us" << std::endl;
+}
+
+// Validates typed array views in both directions
+TEST_F(ArrayBufferTest, TypedArraySpans) {
+    std::vector<double> samples = {1.5, 2.5, 3.5, 4.5};
+    ctx->setGlobalProperty("copied", ctx->newTypedArray(Span<const double>(samples)));
+    ctx->setGlobalProperty("moved", ctx->newTypedArray(std::vector<int32_t>{10, 20, 30}));
+
+    EXPECT_EQ(ctx->eval("copied instanceof Float64Array && copied.length").toInt32(), 4);
+    EXPECT_EQ(ctx->eval("moved instanceof Int32Array && moved[2]").toInt32(), 30);
+
+    // Spans alias JS memory: writes are visible on both sides
+    auto values = ctx->eval("var doubled = new Float64Array([1, 2, 3]); doubled;");
+    auto view = values.asSpan<double>();
+    ASSERT_EQ(view.size(), 3u);
+    EXPECT_DOUBLE_EQ(view[2], 3.0);
+    view[0] = 9;
+    EXPECT_DOUBLE_EQ(ctx->eval("doubled[0]").toNumber(), 9.0);
+
+    // Subarrays start at their byte offset
+    auto tail = ctx->eval("new Uint16Array([1, 2, 3, 4]).subarray(1, 3)").asSpan<const uint16_t>();
+    ASSERT_EQ(tail.size(), 2u);
+    EXPECT_EQ(tail[0], 2);
+    EXPECT_EQ(tail[1], 3);
+
+    // ArrayBuffers are reinterpreted; element types must match for typed arrays
+    auto bytes = ctx->eval("new Float32Array([0.5, 0.25]).buffer").asSpan<float>();
+    ASSERT_EQ(bytes.size(), 2u);
+    EXPECT_FLOAT_EQ(bytes[1], 0.25f);
+    EXPECT_EQ(ctx->eval("new Uint8ClampedArray(5)").asSpan<uint8_t>().size(), 5u);
+    EXPECT_THROW(ctx->eval("new Float32Array(4)").asSpan<double>(), Exception);
+    EXPECT_THROW(ctx->eval("new ArrayBuffer(6)").asSpan<double>(), Exception);
+    EXPECT_THROW(ctx->eval("[1, 2, 3]").asSpan<double>(), Exception);
+}
+
+// Validates that a detached buffer can no longer be viewed
+TEST_F(ArrayBufferTest, DetachedBufferNotViewable) {
+    auto buffer = ctx->newArrayBuffer(std::vector<uint8_t>(64, 3));
+    EXPECT_EQ(buffer.asSpan<uint8_t>().size(), 64u);
+    ctx->detachArrayBuffer(buffer);
+    EXPECT_THROW(buffer.asSpan<uint8_t>(), Exception);
+}
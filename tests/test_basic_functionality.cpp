@@ -299,4 +299,28 @@ TEST_F(BasicFunctionalityTest, FunctionCallsAndMethods) {
     
     auto finalValue = calc.callMethod("getValue", {});
     EXPECT_EQ(finalValue.toInt32(), 15);
-}
\ No newline at end of file
+}
+// Validates QuickJS safely accesses properties and methods through pre-interned keys
+TEST_F(BasicFunctionalityTest, PropertyKeyAccess) {
+    auto nameKey = ctx->newPropertyKey("name");
+    auto greetKey = ctx->newPropertyKey("greet");
+    EXPECT_EQ(nameKey.toString(), "name");
+
+    auto obj = ctx->newObject();
+    obj.setProperty(nameKey, ctx->newString("Alice"));
+    EXPECT_EQ(obj.getProperty(nameKey).toString(), "Alice");
+    EXPECT_EQ(obj.getProperty("name").toString(), "Alice");
+
+    // Keys are reusable across objects and survive copies
+    auto copiedKey = nameKey;
+    auto other = ctx->eval("({ name: 'Bob', greet: function(p) { return p + ' ' + this.name; } })");
+    EXPECT_EQ(other.getProperty(copiedKey).toString(), "Bob");
+
+    auto greeting = other.callMethod(greetKey, {ctx->newString("Hello")});
+    EXPECT_EQ(greeting.toString(), "Hello Bob");
+
+    // Missing properties read as undefined; calling them is an error
+    auto missingKey = ctx->newPropertyKey("missing");
+    EXPECT_TRUE(obj.getProperty(missingKey).isUndefined());
+    EXPECT_THROW(obj.callMethod(missingKey), Exception);
+}
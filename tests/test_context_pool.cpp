@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_context_pool.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating pooled contexts and their replacement between leases
+class ContextPoolTest : public Test {
+protected:
+    static ContextPoolOptions optionsWithSize(size_t size) {
+        ContextPoolOptions options;
+        options.size = size;
+        options.initializer = [](Context& ctx) {
+            ctx.bindGlobalFunction("hostVersion", []() { return 7; });
+            ctx.eval("var config = { mode: 'prod' };");
+        };
+        return options;
+    }
+};
+
+// Validates that request globals are gone and initializer globals intact on the next lease
+TEST_F(ContextPoolTest, ReleaseRestoresBaseline) {
+    ContextPool pool(optionsWithSize(1));
+
+    {
+        auto lease = pool.acquire();
+        lease->eval("var leaked = 1; globalThis.alsoLeaked = 2; config = 'overwritten';");
+        lease->eval("JSON = null; delete globalThis.Math;");
+        EXPECT_EQ(lease->eval("hostVersion()").toInt32(), 7);
+    }
+
+    auto lease = pool.acquire();
+    EXPECT_TRUE(lease->eval("typeof alsoLeaked === 'undefined'").toBool());
+    EXPECT_TRUE(lease->eval("typeof leaked === 'undefined'").toBool());
+    EXPECT_EQ(lease->eval("config.mode").toString(), "prod");
+    EXPECT_EQ(lease->eval("JSON.stringify({a: 1})").toString(), "{\"a\":1}");
+    EXPECT_EQ(lease->eval("Math.max(1, 2)").toInt32(), 2);
+    EXPECT_EQ(lease->eval("hostVersion()").toInt32(), 7);
+}
+
+// Validates that a failed request leaves no pending exception behind
+TEST_F(ContextPoolTest, FailedRequestDoesNotPoisonContext) {
+    ContextPool pool(optionsWithSize(1));
+
+    {
+        auto lease = pool.acquire();
+        EXPECT_THROW(lease->eval("throw new Error('request failed')"), Exception);
+    }
+
+    auto lease = pool.acquire();
+    EXPECT_EQ(lease->eval("1 + 1").toInt32(), 2);
+}
+
+// Validates that state out of reach of the global object does not outlive a lease
+TEST_F(ContextPoolTest, NoStateCarriesOverBetweenLeases) {
+    ContextPool pool(optionsWithSize(1));
+
+    {
+        auto lease = pool.acquire();
+        lease->eval("let perRequest = 1; class Handler {}; Array.prototype.tainted = true;");
+        lease->eval("var settled = []; Promise.resolve(1).then(function (v) { settled.push(v); });");
+    }
+    {
+        // A second request may declare the same top-level bindings
+        auto lease = pool.acquire();
+        EXPECT_EQ(lease->eval("typeof perRequest").toString(), "undefined");
+        EXPECT_EQ(lease->eval("typeof Handler").toString(), "undefined");
+        EXPECT_FALSE(lease->eval("'tainted' in []").toBool());
+        EXPECT_EQ(lease->eval("typeof settled").toString(), "undefined");
+        EXPECT_NO_THROW(lease->eval("let perRequest = 2; class Handler {};"));
+        EXPECT_EQ(lease->eval("config.mode").toString(), "prod");
+    }
+    EXPECT_FALSE(JS_IsJobPending(pool.acquire()->getJSRuntime()));
+}
+
+// Validates that releasing a lease on a shared runtime leaves other leases' jobs queued
+TEST_F(ContextPoolTest, SharedRuntimeKeepsOtherLeasesJobs) {
+    auto options = optionsWithSize(2);
+    options.runtime = std::make_shared<Runtime>();
+    ContextPool pool(options);
+
+    auto busy = pool.acquire();
+    busy->eval("var settled = false; Promise.resolve().then(function () { settled = true; });");
+    pool.acquire().release();
+
+    EXPECT_FALSE(busy->eval("settled").toBool());
+    ASSERT_TRUE(JS_IsJobPending(options.runtime->getJSRuntime()));
+    JSContext* jobCtx = nullptr;
+    EXPECT_EQ(JS_ExecutePendingJob(options.runtime->getJSRuntime(), &jobCtx), 1);
+    EXPECT_TRUE(busy->eval("settled").toBool());
+}
+
+// Validates that private runtimes are replaced after the configured number of uses
+TEST_F(ContextPoolTest, ReplacesRuntimeAfterMaxUses) {
+    auto options = optionsWithSize(1);
+    options.maxUsesPerRuntime = 2;
+    ContextPool pool(options);
+
+    std::vector<const Runtime*> runtimes;
+    for (int i = 0; i < 5; ++i) {
+        auto lease = pool.acquire();
+        runtimes.push_back(lease->getRuntime().get());
+        EXPECT_EQ(lease->eval("hostVersion()").toInt32(), 7);
+    }
+    EXPECT_EQ(runtimes[0], runtimes[1]);
+    EXPECT_NE(runtimes[1], runtimes[2]);
+
+    auto metrics = pool.getMetrics();
+    EXPECT_EQ(metrics.acquisitions, 5u);
+    EXPECT_EQ(metrics.releases, 5u);
+    EXPECT_EQ(metrics.recreations, 2u);
+}
+
+// Validates that failed recreation retries, then shrinks the pool without stranding waiters
+TEST_F(ContextPoolTest, FailedRecreationShrinksPool) {
+    int failuresLeft = 0;
+    ContextPoolOptions options;
+    options.size = 2;
+    options.initializer = [&failuresLeft](Context&) {
+        if (failuresLeft > 0) {
+            failuresLeft--;
+            throw std::runtime_error("initializer failed");
+        }
+    };
+    ContextPool pool(options);
+
+    // One failure: the entry is rebuilt from scratch
+    failuresLeft = 1;
+    pool.acquire();
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_EQ(pool.available(), 2u);
+
+    // The retry fails too: the entry is dropped
+    failuresLeft = 2;
+    pool.acquire();
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_EQ(pool.getMetrics().discarded, 1u);
+
+    auto last = pool.acquire();
+    std::atomic<bool> waiterFailed{false};
+    std::thread waiter([&]() {
+        try {
+            pool.acquire();
+        } catch (const Exception&) {
+            waiterFailed = true;
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    failuresLeft = 2;
+    last.release();
+    waiter.join();
+
+    EXPECT_TRUE(waiterFailed);
+    EXPECT_EQ(pool.size(), 0u);
+    EXPECT_THROW(pool.acquire(), Exception);
+}
+
+// Validates that leases block when the pool is exhausted and are shared across threads
+TEST_F(ContextPoolTest, ConcurrentLeasesAcrossThreads) {
+    ContextPool pool(optionsWithSize(2));
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 6; ++t) {
+        threads.emplace_back([&pool, &failures, t]() {
+            for (int i = 0; i < 50; ++i) {
+                auto lease = pool.acquire();
+                auto result = lease->eval("var request = " + std::to_string(t * 1000 + i) + "; request;");
+                if (result.toInt32() != t * 1000 + i) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(pool.available(), 2u);
+    auto metrics = pool.getMetrics();
+    EXPECT_EQ(metrics.acquisitions, 300u);
+    EXPECT_EQ(metrics.releases, 300u);
+}
+
+// Validates stack limits for leases taken on other threads and the shared-runtime thread binding
+TEST_F(ContextPoolTest, LeaseThreadStackLimits) {
+    ContextPool pool(optionsWithSize(1));
+    int depth = 0;
+    bool overflowCaught = false;
+    std::thread worker([&]() {
+        auto lease = pool.acquire();
+        depth = lease->eval("(function f(n) { return n === 0 ? 0 : f(n - 1) + 1; })(2000)").toInt32();
+        try {
+            lease->eval("(function g() { return g() + 1; })()");
+        } catch (const Exception&) {
+            overflowCaught = true;
+        }
+    });
+    worker.join();
+    EXPECT_EQ(depth, 2000);
+    EXPECT_TRUE(overflowCaught);
+
+    auto options = optionsWithSize(1);
+    options.runtime = std::make_shared<Runtime>();
+    ContextPool shared(options);
+    EXPECT_EQ(shared.acquire()->eval("hostVersion()").toInt32(), 7);
+    bool rejected = false;
+    std::thread other([&]() {
+        try {
+            shared.acquire();
+        } catch (const Exception&) {
+            rejected = true;
+        }
+    });
+    other.join();
+    EXPECT_TRUE(rejected);
+}
+
+// Benchmark: pooled leases versus creating a fresh runtime and context per request.
+// The pool still creates and initializes a context per lease; it saves the
+// runtime setup and keeps that work off the acquire path.
+TEST_F(ContextPoolTest, ResetVersusRecreateLatency) {
+    const int requests = 200;
+    auto options = optionsWithSize(1);
+    ContextPool pool(options);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < requests; ++i) {
+        auto lease = pool.acquire();
+        lease->eval("var scratch = [1, 2, 3].map(function(x) { return x * 2; });");
+    }
+    auto pooled = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < requests; ++i) {
+        Context fresh;
+        options.initializer(fresh);
+        fresh.eval("var scratch = [1, 2, 3].map(function(x) { return x * 2; });");
+    }
+    auto recreated = std::chrono::steady_clock::now() - start;
+
+    auto metrics = pool.getMetrics();
+    auto usPerRequest = [requests](std::chrono::nanoseconds total) {
+        return std::chrono::duration<double, std::micro>(total).count() / requests;
+    };
+    std::cout << "Pooled request: " << usPerRequest(pooled) << " us" << std::endl;
+    std::cout << "  acquire avg: " << usPerRequest(metrics.totalAcquireTime) << " us, max: "
+              << std::chrono::duration<double, std::micro>(metrics.maxAcquireTime).count() << " us" << std::endl;
+    std::cout << "  release avg: " << usPerRequest(metrics.totalReleaseTime) << " us, max: "
+              << std::chrono::duration<double, std::micro>(metrics.maxReleaseTime).count() << " us" << std::endl;
+    std::cout << "Fresh context per request: " << usPerRequest(recreated) << " us" << std::endl;
+}
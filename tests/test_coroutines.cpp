@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_event_loop.h"
+#include <memory>
+#include <string>
+
+#ifndef QUICKJS_WRAPPER_HAS_COROUTINES
+#error "test_coroutines.cpp must be built as C++20 with coroutine support"
+#endif
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+namespace {
+    // Minimal eagerly started coroutine for the tests
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    Detached sumLater(EventLoop& loop, Context& ctx, int& out, std::string& error) {
+        QuickJSWrapper::Value a = co_await loop.awaitable(ctx.eval("Promise.resolve(40)"));
+        QuickJSWrapper::Value b = co_await loop.awaitable(
+            ctx.eval("new Promise(function (resolve) { setTimeout(function () { resolve(2); }, 5); })"));
+        out = a.toInt32() + b.toInt32();
+        try {
+            co_await loop.awaitable(ctx.eval("Promise.reject(new Error('nope'))"));
+        } catch (const Exception& e) {
+            error = e.what();
+        }
+    }
+
+    Detached awaitPlain(EventLoop& loop, Context& ctx, std::string& out) {
+        QuickJSWrapper::Value value = co_await loop.awaitable(ctx.eval("'plain'"));
+        out = value.toString();
+    }
+}
+
+// Tests validating co_await on JavaScript promises through EventLoop::PromiseAwaiter
+class CoroutineTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+        loop = std::make_unique<EventLoop>(*ctx);
+    }
+
+    void TearDown() override {
+        loop.reset();
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+    std::unique_ptr<EventLoop> loop;
+};
+
+// Validates co_await on fulfilled, timer-settled and rejected promises
+TEST_F(CoroutineTest, AwaitPromises) {
+    int sum = 0;
+    std::string error;
+    sumLater(*loop, *ctx, sum, error);
+    loop->run();
+    EXPECT_EQ(sum, 42);
+    EXPECT_THAT(error, HasSubstr("nope"));
+}
+
+// Validates that values which are not promises resume with themselves
+TEST_F(CoroutineTest, AwaitPlainValue) {
+    std::string result;
+    awaitPlain(*loop, *ctx, result);
+    loop->run();
+    EXPECT_EQ(result, "plain");
+}
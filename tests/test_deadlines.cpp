@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include <chrono>
+#include <memory>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+using namespace std::chrono_literals;
+
+// Tests validating execution deadlines enforced through the interrupt handler
+class DeadlineTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+    }
+
+    void TearDown() override {
+        ctx.reset();
+    }
+
+    // The same checks StackOverflowRecovery applies after a stack overflow
+    void expectContextUsable() {
+        EXPECT_EQ(ctx->eval("1 + 1").toInt32(), 2);
+        ctx->eval("function safe() { return 'safe'; }");
+        EXPECT_EQ(ctx->eval("safe()").toString(), "safe");
+        ctx->eval("var arr = []; for (var i = 0; i < 100; i++) arr.push(i * 2);");
+        EXPECT_EQ(ctx->eval("arr.length").toInt32(), 100);
+    }
+
+    std::unique_ptr<Context> ctx;
+};
+
+// Validates that an infinite loop is stopped by a wall-clock deadline
+TEST_F(DeadlineTest, InfiniteLoopTimesOut) {
+    auto start = std::chrono::steady_clock::now();
+    {
+        DeadlineScope deadline(*ctx, 50ms);
+        EXPECT_THROW(ctx->eval("while (true) {}"), TimeoutException);
+        EXPECT_TRUE(deadline.expired());
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 2s);
+    expectContextUsable();
+}
+
+// Validates that scripts cannot catch the interruption and keep running
+TEST_F(DeadlineTest, TimeoutIsUncatchable) {
+    DeadlineScope deadline(*ctx, 50ms);
+    EXPECT_THROW(ctx->eval(R"(
+        while (true) {
+            try {
+                for (;;) {}
+            } catch (e) {
+                // swallowing must not work
+            }
+        }
+    )"), TimeoutException);
+}
+
+// Validates the instruction budget independently of the clock
+TEST_F(DeadlineTest, InterruptBudget) {
+    Deadline budget;
+    budget.interruptBudget = 20;
+
+    {
+        DeadlineScope deadline(*ctx, budget);
+        EXPECT_EQ(ctx->eval("var s = 0; for (var i = 0; i < 100; i++) s += i; s").toInt32(), 4950);
+    }
+    {
+        DeadlineScope deadline(*ctx, budget);
+        EXPECT_THROW(ctx->eval("for (var i = 0; ; i++) {}"), TimeoutException);
+    }
+    expectContextUsable();
+}
+
+// Validates that function calls through Value honour the deadline
+TEST_F(DeadlineTest, FunctionCallTimesOut) {
+    auto spin = ctx->eval("(function spin() { for (;;) {} })");
+    DeadlineScope deadline(*ctx, 30ms);
+    EXPECT_THROW(spin.call(), TimeoutException);
+}
+
+// Validates that nested scopes use the tighter deadline and restore the outer one
+TEST_F(DeadlineTest, NestedScopes) {
+    DeadlineScope outer(*ctx, 10s);
+    {
+        DeadlineScope inner(*ctx, 30ms);
+        EXPECT_THROW(ctx->eval("while (true) {}"), TimeoutException);
+    }
+    EXPECT_FALSE(outer.expired());
+    EXPECT_EQ(ctx->eval("var n = 0; for (var i = 0; i < 100000; i++) n++; n").toInt32(), 100000);
+}
+
+// Validates that ordinary errors inside a scope are not reported as timeouts
+TEST_F(DeadlineTest, ScriptErrorsAreNotTimeouts) {
+    DeadlineScope deadline(*ctx, 10s);
+    try {
+        ctx->eval("throw new Error('plain failure')");
+        FAIL() << "Expected an exception";
+    } catch (const TimeoutException&) {
+        FAIL() << "Script error reported as timeout";
+    } catch (const Exception&) {
+    }
+}
+
+// Validates that a timeout inside native -> JS -> native chains still reaches
+// the outermost evaluation after the callbacks turn it into JS errors
+TEST_F(DeadlineTest, NestedNativeCallsReportTimeout) {
+    ctx->setGlobalFunction("spinNative", [this](const std::vector<QuickJSWrapper::Value>&) -> QuickJSWrapper::Value {
+        return ctx->eval("for (;;) {}");
+    });
+    ctx->bindGlobalFunction("spinTyped", [this]() {
+        ctx->eval("spinNative()");
+    });
+
+    DeadlineScope deadline(*ctx, 30ms);
+    EXPECT_THROW(ctx->eval(R"(
+        try {
+            spinTyped();
+        } catch (e) {
+            // the caller regains control with no loop left to poll
+        }
+        throw new Error('after the nested timeout');
+    )"), TimeoutException);
+    EXPECT_TRUE(deadline.expired());
+}
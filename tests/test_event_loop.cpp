@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_event_loop.h"
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#endif
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating the timer wheel against a reference model
+class TimerWheelTest : public Test {
+};
+
+// Validates expiry, cancellation and nextExpiry across all wheel levels
+TEST_F(TimerWheelTest, MatchesReferenceModel) {
+    std::mt19937_64 rng(7);
+    TimerWheel wheel;
+    std::map<TimerWheel::Id, uint64_t> expected;
+    std::vector<TimerWheel::Id> due;
+    uint64_t now = 0;
+    TimerWheel::Id nextId = 1;
+
+    for (int step = 0; step < 20000; ++step) {
+        int op = static_cast<int>(rng() % 10);
+        if (op < 5) {
+            // Mix of near, mid-range and overflow expiries
+            uint64_t range = rng() % 4 == 0 ? (uint64_t(1) << 26) : (rng() % 2 ? 5000 : 70);
+            uint64_t expires = now + rng() % range;
+            wheel.schedule(nextId, expires);
+            expected[nextId++] = expires;
+        } else if (op == 5 && !expected.empty()) {
+            auto it = expected.begin();
+            std::advance(it, rng() % expected.size());
+            ASSERT_TRUE(wheel.cancel(it->first));
+            expected.erase(it);
+        } else {
+            uint64_t earliest = TimerWheel::kNever;
+            for (const auto& [id, expires] : expected) {
+                earliest = std::min(earliest, std::max(expires, wheel.now()));
+            }
+            ASSERT_EQ(wheel.nextExpiry(), earliest);
+
+            now += rng() % 3 == 0 ? rng() % (uint64_t(1) << 25) : rng() % 200;
+            due.clear();
+            wheel.advance(now, due);
+            for (TimerWheel::Id id : due) {
+                auto it = expected.find(id);
+                ASSERT_NE(it, expected.end());
+                ASSERT_LE(it->second, now);
+                expected.erase(it);
+            }
+            for (const auto& [id, expires] : expected) {
+                ASSERT_GT(expires, now) << "timer " << id << " missed";
+            }
+            ASSERT_EQ(wheel.size(), expected.size());
+        }
+    }
+}
+
+// Validates that cancelled timers never fire and ids can be rescheduled
+TEST_F(TimerWheelTest, CancelAndReschedule) {
+    TimerWheel wheel;
+    wheel.schedule(1, 10);
+    wheel.schedule(2, 10);
+    wheel.schedule(1, 500);
+    EXPECT_TRUE(wheel.cancel(2));
+    EXPECT_FALSE(wheel.cancel(2));
+
+    std::vector<TimerWheel::Id> due;
+    wheel.advance(100, due);
+    EXPECT_TRUE(due.empty());
+    wheel.advance(500, due);
+    EXPECT_THAT(due, ElementsAre(1u));
+    EXPECT_TRUE(wheel.empty());
+}
+
+// Tests validating promise job draining and JS timers
+class EventLoopTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+        loop = std::make_unique<EventLoop>(*ctx);
+    }
+
+    void TearDown() override {
+        loop.reset();
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+    std::unique_ptr<EventLoop> loop;
+};
+
+// Validates that timeouts fire in delay order with their extra arguments
+TEST_F(EventLoopTest, TimeoutsFireInOrder) {
+    ctx->eval(R"(
+        var order = [];
+        setTimeout(function () { order.push('slow'); }, 30);
+        setTimeout(function () { order.push('fast'); }, 5);
+        setTimeout(function (a, b) { order.push(a + b); }, 0, 'zero', 1);
+    )");
+    EXPECT_EQ(loop->pendingTimers(), 3u);
+
+    loop->run();
+    EXPECT_EQ(ctx->eval("order.join(',')").toString(), "zero1,fast,slow");
+    EXPECT_EQ(loop->pendingTimers(), 0u);
+}
+
+// Validates clearTimeout and clearInterval
+TEST_F(EventLoopTest, ClearAndIntervals) {
+    ctx->eval(R"(
+        var fired = false;
+        var ticks = 0;
+        var cancelled = setTimeout(function () { fired = true; }, 5);
+        clearTimeout(cancelled);
+        var interval = setInterval(function () {
+            if (++ticks === 5) clearInterval(interval);
+        }, 1);
+    )");
+
+    loop->run();
+    EXPECT_FALSE(ctx->eval("fired").toBool());
+    EXPECT_EQ(ctx->eval("ticks").toInt32(), 5);
+}
+
+// Validates that out-of-range delays are clamped instead of firing at once
+TEST_F(EventLoopTest, DelaysOutsideTheRange) {
+    ctx->eval(R"(
+        var fired = [];
+        setTimeout(function () { fired.push('huge'); }, 1e20);
+        setTimeout(function () { fired.push('infinite'); }, Infinity);
+        setTimeout(function () { fired.push('negative'); }, -5);
+        setTimeout(function () { fired.push('nan'); }, NaN);
+    )");
+    EXPECT_EQ(loop->pendingTimers(), 4u);
+
+    loop->runOnce();
+    EXPECT_EQ(ctx->eval("fired.join(',')").toString(), "negative,nan");
+    EXPECT_EQ(loop->pendingTimers(), 2u);
+    EXPECT_GT(loop->timeUntilNextTimer(), std::chrono::hours(24));
+    EXPECT_LE(loop->timeUntilNextTimer(), std::chrono::milliseconds(2147483647));
+}
+
+// Validates that clearing with ids that cannot name a timer is a no-op
+TEST_F(EventLoopTest, ClearWithInvalidIds) {
+    ctx->eval(R"(
+        var fired = false;
+        setTimeout(function () { fired = true; }, 1);
+        clearTimeout(-1);
+        clearTimeout(NaN);
+        clearTimeout(Infinity);
+        clearTimeout(-Infinity);
+        clearTimeout(1.5);
+        clearTimeout(0);
+        clearTimeout(1e300);
+        clearInterval(-1);
+    )");
+    EXPECT_EQ(loop->pendingTimers(), 1u);
+
+    loop->run();
+    EXPECT_TRUE(ctx->eval("fired").toBool());
+}
+
+// Validates that promise jobs run, including those queued by timers
+TEST_F(EventLoopTest, PromiseJobsDrained) {
+    ctx->eval(R"(
+        var log = [];
+        Promise.resolve(1).then(function (v) { log.push('then' + v); });
+        setTimeout(function () {
+            Promise.resolve(2).then(function (v) { log.push('then' + v); });
+            log.push('timer');
+        }, 1);
+    )");
+    EXPECT_TRUE(loop->hasPendingJobs());
+    EXPECT_EQ(loop->runPendingJobs(), 1u);
+
+    loop->run();
+    EXPECT_EQ(ctx->eval("log.join(',')").toString(), "then1,timer,then2");
+}
+
+// Validates that callback errors surface and the loop keeps working
+TEST_F(EventLoopTest, CallbackErrorsPropagate) {
+    ctx->eval(R"(
+        var after = false;
+        setTimeout(function () { throw new Error('timer failed'); }, 0);
+        setTimeout(function () { after = true; }, 2);
+    )");
+
+    EXPECT_THROW(loop->run(), Exception);
+    loop->run();
+    EXPECT_TRUE(ctx->eval("after").toBool());
+}
+
+// Validates scheduling and cancelling a large number of timers
+TEST_F(EventLoopTest, ManyTimers) {
+    auto start = std::chrono::steady_clock::now();
+    ctx->eval(R"(
+        var count = 0;
+        var ids = [];
+        for (var i = 0; i < 100000; i++) {
+            ids.push(setTimeout(function () { count++; }, i % 50));
+        }
+        for (var j = 0; j < ids.length; j += 2) {
+            clearTimeout(ids[j]);
+        }
+    )");
+    EXPECT_EQ(loop->pendingTimers(), 50000u);
+
+    loop->run();
+    EXPECT_EQ(ctx->eval("count").toInt32(), 50000);
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "100000 timers scheduled, 50000 cancelled and 50000 fired in " << elapsedMs << " ms" << std::endl;
+}
+
+// Validates that destroying the loop disables the timer functions
+TEST_F(EventLoopTest, FunctionsRemovedWithLoop) {
+    ctx->eval("var keep = setTimeout;");
+    loop.reset();
+    EXPECT_EQ(ctx->eval("typeof setTimeout").toString(), "undefined");
+    EXPECT_THROW(ctx->eval("keep(function () {}, 0)"), Exception);
+}
+
+#ifdef __linux__
+// Validates that the timer descriptor becomes readable when a timer is due
+TEST_F(EventLoopTest, PollableDescriptor) {
+    ASSERT_GE(loop->fd(), 0);
+    ctx->eval("var done = false; setTimeout(function () { done = true; }, 20);");
+
+    pollfd pfd{loop->fd(), POLLIN, 0};
+    EXPECT_EQ(poll(&pfd, 1, 0), 0);
+    ASSERT_EQ(poll(&pfd, 1, 1000), 1);
+
+    EXPECT_FALSE(loop->runOnce());
+    EXPECT_TRUE(ctx->eval("done").toBool());
+}
+#endif
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_executor.h"
+#include <future>
+#include <vector>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating the multi-threaded script executor
+class ExecutorTest : public Test {
+protected:
+    // Context on the test thread used to encode arguments and decode results
+    Context local;
+
+    QuickJSWrapper::Value decode(std::future<std::vector<uint8_t>>& future) {
+        return local.deserialize(future.get());
+    }
+};
+
+// Validates that source jobs run on the workers and return their completion value
+TEST_F(ExecutorTest, RunsSourceJobs) {
+    ExecutorOptions options;
+    options.threads = 4;
+    Executor executor(options);
+    EXPECT_EQ(executor.size(), 4u);
+
+    std::vector<std::future<std::vector<uint8_t>>> results;
+    for (int i = 0; i < 200; ++i) {
+        ScriptJob job;
+        job.source = "(" + std::to_string(i) + " * 2)";
+        results.push_back(executor.submit(std::move(job)));
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(decode(results[i]).toInt32(), i * 2);
+    }
+    auto metrics = executor.getMetrics();
+    EXPECT_EQ(metrics.submitted, 200u);
+    EXPECT_EQ(metrics.completed, 200u);
+    EXPECT_EQ(metrics.failed, 0u);
+}
+
+// Validates that jobs call functions installed by the initializer with transferred arguments
+TEST_F(ExecutorTest, CallsInitializedFunctionWithArguments) {
+    ExecutorOptions options;
+    options.threads = 2;
+    options.initializer = [](Context& ctx) {
+        ctx.eval(R"(
+            function summarize(order) {
+                var total = 0;
+                for (var i = 0; i < order.items.length; i++) {
+                    total += order.items[i].price * order.items[i].qty;
+                }
+                return { id: order.id, total: total };
+            }
+        )");
+    };
+    Executor executor(options);
+
+    ScriptJob job;
+    job.function = "summarize";
+    job.args.push_back(local.eval(
+        "({ id: 'A1', items: [{ price: 2.5, qty: 4 }, { price: 1, qty: 3 }] })").serialize());
+    auto future = executor.submit(std::move(job));
+
+    auto summary = decode(future);
+    EXPECT_EQ(summary.getProperty("id").toString(), "A1");
+    EXPECT_DOUBLE_EQ(summary.getProperty("total").toNumber(), 13.0);
+}
+
+// Validates that precompiled bytecode can be shipped to the workers
+TEST_F(ExecutorTest, RunsPrecompiledBytecode) {
+    ExecutorOptions options;
+    options.threads = 2;
+    Executor executor(options);
+
+    auto script = local.compile("[1, 2, 3].map(function (x) { return x * x; })", "squares.js");
+    ScriptJob job;
+    job.bytecode = script.serialize();
+    auto future = executor.submit(std::move(job));
+
+    auto squares = decode(future);
+    ASSERT_TRUE(squares.isArray());
+    EXPECT_EQ(squares.getElement(2).toInt32(), 9);
+}
+
+// Validates that script errors reach the caller and the worker keeps serving jobs
+TEST_F(ExecutorTest, ErrorsDeliveredThroughFuture) {
+    ExecutorOptions options;
+    options.threads = 1;
+    Executor executor(options);
+
+    ScriptJob failing;
+    failing.source = "throw new Error('job failed')";
+    auto failed = executor.submit(std::move(failing));
+    EXPECT_THROW(failed.get(), Exception);
+
+    ScriptJob missing;
+    missing.function = "notDefined";
+    auto unresolved = executor.submit(std::move(missing));
+    EXPECT_THROW(unresolved.get(), Exception);
+
+    ScriptJob ok;
+    ok.source = "'still running'";
+    auto future = executor.submit(std::move(ok));
+    EXPECT_EQ(decode(future).toString(), "still running");
+    EXPECT_EQ(executor.getMetrics().failed, 2u);
+}
+
+// Validates that queued jobs complete before the executor is destroyed
+TEST_F(ExecutorTest, DestructorDrainsQueuedJobs) {
+    std::vector<std::future<std::vector<uint8_t>>> results;
+    {
+        ExecutorOptions options;
+        options.threads = 2;
+        Executor executor(options);
+        for (int i = 0; i < 50; ++i) {
+            ScriptJob job;
+            job.source = "var s = 0; for (var i = 0; i < 10000; i++) s += i; s";
+            results.push_back(executor.submit(std::move(job)));
+        }
+    }
+
+    for (auto& future : results) {
+        EXPECT_EQ(decode(future).toNumber(), 49995000.0);
+    }
+}
+
+// Validates that initializer failures are reported by the constructor
+TEST_F(ExecutorTest, InitializerFailureThrows) {
+    ExecutorOptions options;
+    options.threads = 3;
+    options.initializer = [](Context& ctx) {
+        ctx.eval("syntax error here");
+    };
+    EXPECT_THROW(Executor executor(options), Exception);
+}
+
+// Validates that a runaway job is stopped by its timeout and frees the worker
+TEST_F(ExecutorTest, JobTimeoutFreesWorker) {
+    ExecutorOptions options;
+    options.threads = 1;
+    Executor executor(options);
+
+    ScriptJob runaway;
+    runaway.source = "while (true) {}";
+    runaway.timeout = std::chrono::milliseconds(50);
+    auto stuck = executor.submit(std::move(runaway));
+    EXPECT_THROW(stuck.get(), TimeoutException);
+
+    ScriptJob next;
+    next.source = "'next job'";
+    auto future = executor.submit(std::move(next));
+    EXPECT_EQ(decode(future).toString(), "next job");
+}
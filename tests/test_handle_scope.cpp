@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include <memory>
+#include <string>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+namespace {
+    int refCount(ValueRef value) {
+        return static_cast<JSRefCountHeader*>(JS_VALUE_GET_PTR(value.getJSValue()))->ref_count;
+    }
+}
+
+// Tests validating scoped handle arenas
+class HandleScopeTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+    }
+
+    void TearDown() override {
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+};
+
+// Validates a traversal through scoped handles
+TEST_F(HandleScopeTest, TraversesObjectGraph) {
+    ctx->eval(R"(
+        var tree = { value: 1, children: [
+            { value: 2, children: [{ value: 4, children: [] }] },
+            { value: 3, children: [] }
+        ] };
+    )");
+    auto tree = ctx->getGlobalProperty("tree");
+    auto valueKey = ctx->newPropertyKey("value");
+    auto childrenKey = ctx->newPropertyKey("children");
+
+    HandleScope scope(*ctx);
+    std::function<int(ValueRef)> sum = [&](ValueRef node) {
+        int total = scope.getProperty(node, valueKey).toInt32();
+        ValueRef children = scope.getProperty(node, childrenKey);
+        size_t count = children.getArrayLength();
+        for (uint32_t i = 0; i < count; ++i) {
+            total += sum(scope.getElement(children, i));
+        }
+        return total;
+    };
+    EXPECT_EQ(sum(tree), 10);
+    // Each node contributes its value, its children array and itself (but the root)
+    EXPECT_EQ(scope.size(), 4u * 3 - 1);
+}
+
+// Validates that references taken in a scope are released when it closes
+TEST_F(HandleScopeTest, ReleasesOnExit) {
+    auto object = ctx->eval("({ inner: {} })");
+    auto inner = object.getProperty("inner");
+    int before = refCount(inner);
+
+    {
+        HandleScope scope(*ctx);
+        ValueRef first = scope.getProperty(object, "inner");
+        ValueRef second = scope.keep(object.getProperty("inner"));
+        EXPECT_EQ(refCount(first), before + 2);
+        EXPECT_EQ(JS_VALUE_GET_PTR(second.getJSValue()), JS_VALUE_GET_PTR(first.getJSValue()));
+        scope.adopt(JS_NewObject(ctx->getJSContext()));
+        scope.getProperty(object, "missing");
+        EXPECT_EQ(scope.size(), 4u);
+    }
+    EXPECT_EQ(refCount(inner), before);
+
+    // Keeping a borrowed value takes a reference of its own
+    QuickJSWrapper::Value borrowed(ctx->getJSContext(), inner.getJSValue(), false);
+    {
+        HandleScope scope(*ctx);
+        scope.keep(borrowed);
+        EXPECT_EQ(refCount(inner), before + 1);
+    }
+    EXPECT_EQ(refCount(inner), before);
+}
+
+// Validates nesting and that only the innermost scope takes handles
+TEST_F(HandleScopeTest, NestedScopes) {
+    auto object = ctx->eval("({ a: {}, b: {} })");
+    auto a = object.getProperty("a");
+    int before = refCount(a);
+
+    HandleScope outer(*ctx);
+    outer.getProperty(object, "a");
+    {
+        HandleScope inner(*ctx);
+        inner.getProperty(object, "a");
+        inner.getProperty(object, "a");
+        EXPECT_EQ(refCount(a), before + 3);
+        EXPECT_THROW(outer.getProperty(object, "b"), Exception);
+        EXPECT_EQ(outer.size(), 1u);
+        EXPECT_EQ(inner.size(), 2u);
+    }
+    EXPECT_EQ(refCount(a), before + 1);
+    outer.getProperty(object, "b");
+    EXPECT_EQ(outer.size(), 2u);
+}
+
+// Validates that open scopes survive a move of their context
+TEST_F(HandleScopeTest, ContextMove) {
+    std::unique_ptr<Context> moved;
+    auto object = ctx->eval("({ name: 'kept' })");
+    {
+        HandleScope scope(*ctx);
+        ValueRef name = scope.getProperty(object, "name");
+
+        moved = std::make_unique<Context>(std::move(*ctx));
+        EXPECT_EQ(name.toString(), "kept");
+        EXPECT_EQ(scope.getProperty(object, "name").toString(), "kept");
+        EXPECT_EQ(scope.size(), 2u);
+    }
+}
@@ -490,4 +490,85 @@ TEST_F(MemoryExhaustionTest, MemoryRecoveryCapability) {
     EXPECT_EQ(status.toString(), "recovered");
     
     std::cout << "Context successfully recovered from memory exhaustion" << std::endl;
-}
\ No newline at end of file
+}
+
+// Validates that the runtime memory limit stops runaway allocation with a distinct exception
+TEST_F(MemoryExhaustionTest, MemoryLimitRaisesOutOfMemory) {
+    const size_t limit = ctx->getMemoryUsage() + 8 * 1024 * 1024;
+    ctx->setMemoryLimit(limit);
+    EXPECT_EQ(ctx->getMemoryLimit(), limit);
+
+    EXPECT_THROW(ctx->eval(R"(
+        var hogs = [];
+        while (true) {
+            hogs.push('x'.repeat(10000) + hogs.length);
+        }
+    )"), OutOfMemoryException);
+
+    EXPECT_GT(ctx->getMemoryStats().limitHits, 0u);
+    EXPECT_LE(ctx->getMemoryUsage(), limit);
+
+    // Releasing the retained data makes the context usable again
+    ctx->eval("hogs = null;");
+    ctx->runGC();
+    EXPECT_EQ(ctx->eval("'recovered'").toString(), "recovered");
+
+    // Ordinary script errors are not reported as out of memory
+    try {
+        ctx->eval("throw new Error('not memory related')");
+        FAIL() << "Expected an exception";
+    } catch (const OutOfMemoryException&) {
+        FAIL() << "Script error reported as out of memory";
+    } catch (const Exception&) {
+    }
+}
+
+// Validates limit and GC threshold configuration at construction and at runtime
+TEST_F(MemoryExhaustionTest, MemoryLimitAndGCThresholdConfiguration) {
+    RuntimeOptions options;
+    options.memoryLimit = 32 * 1024 * 1024;
+    options.gcThreshold = 512 * 1024;
+    Context limited(options);
+
+    EXPECT_EQ(limited.getMemoryLimit(), options.memoryLimit);
+    EXPECT_EQ(limited.getGCThreshold(), options.gcThreshold);
+    EXPECT_EQ(limited.eval("[1, 2, 3].length").toInt32(), 3);
+
+    limited.setGCThreshold(2 * 1024 * 1024);
+    EXPECT_EQ(limited.getGCThreshold(), 2u * 1024 * 1024);
+
+    // Lifting the limit allows what it previously refused
+    limited.setMemoryLimit(limited.getMemoryUsage() + 1024 * 1024);
+    EXPECT_THROW(limited.eval("var big = 'y'.repeat(4 * 1024 * 1024);"), OutOfMemoryException);
+    limited.setMemoryLimit(0);
+    EXPECT_EQ(limited.eval("var big = 'y'.repeat(4 * 1024 * 1024); big.length").toInt32(), 4 * 1024 * 1024);
+}
+
+// Validates that an allocation failure caught by the script does not mislabel later errors
+TEST_F(MemoryExhaustionTest, CaughtOutOfMemoryDoesNotLeak) {
+    ctx->setMemoryLimit(ctx->getMemoryUsage() + 4 * 1024 * 1024);
+
+    EXPECT_TRUE(ctx->eval(R"(
+        var caught = false;
+        try {
+            var huge = 'z'.repeat(16 * 1024 * 1024);
+        } catch (e) {
+            caught = true;
+        }
+        caught;
+    )").toBool());
+    EXPECT_GT(ctx->getMemoryStats().limitHits, 0u);
+
+    try {
+        ctx->eval("null.property");
+        FAIL() << "Expected an exception";
+    } catch (const OutOfMemoryException&) {
+        FAIL() << "TypeError reported as out of memory";
+    } catch (const Exception& e) {
+        EXPECT_THAT(e.what(), HasSubstr("TypeError"));
+    }
+
+    // A rethrown allocation failure is still reported as one
+    EXPECT_THROW(ctx->eval("try { 'z'.repeat(16 * 1024 * 1024); } catch (e) { throw e; }"),
+                 OutOfMemoryException);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+namespace {
+    double addNumbers(double a, double b) {
+        return a + b;
+    }
+
+    std::string repeatText(std::string_view text, int count) {
+        std::string result;
+        for (int i = 0; i < count; ++i) {
+            result.append(text);
+        }
+        return result;
+    }
+}
+
+// Tests validating native function registration and dispatch
+class NativeBindingsTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+    }
+
+    void TearDown() override {
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+};
+
+// Validates that many functions registered on one context dispatch to the right callable
+TEST_F(NativeBindingsTest, ManyFunctionsDispatchIndependently) {
+    const int functionCount = 2000;
+    for (int i = 0; i < functionCount; ++i) {
+        ctx->setGlobalFunction("fn" + std::to_string(i), [this, i](const std::vector<QuickJSWrapper::Value>&) -> QuickJSWrapper::Value {
+            return ctx->newInt32(i);
+        });
+    }
+
+    auto result = ctx->eval(R"(
+        var sum = 0;
+        for (var i = 0; i < 2000; i++) {
+            sum += globalThis['fn' + i]();
+        }
+        sum;
+    )");
+    EXPECT_EQ(result.toInt32(), functionCount * (functionCount - 1) / 2);
+
+    auto name = ctx->eval("fn42.name");
+    EXPECT_EQ(name.toString(), "fn42");
+}
+
+// Validates that the callable is released once the function object is collected
+TEST_F(NativeBindingsTest, CallableReleasedWhenFunctionCollected) {
+    auto sentinel = std::make_shared<int>(7);
+    std::weak_ptr<int> watcher = sentinel;
+
+    ctx->setGlobalFunction("captured", [sentinel, this](const std::vector<QuickJSWrapper::Value>&) -> QuickJSWrapper::Value {
+        return ctx->newInt32(*sentinel);
+    });
+    sentinel.reset();
+
+    EXPECT_EQ(ctx->eval("captured()").toInt32(), 7);
+    EXPECT_FALSE(watcher.expired());
+
+    ctx->eval("delete globalThis.captured;");
+    ctx->runGC();
+    EXPECT_TRUE(watcher.expired());
+}
+
+// Validates that callables are released when their context is destroyed
+TEST_F(NativeBindingsTest, CallablesReleasedWithShortLivedContexts) {
+    auto sentinel = std::make_shared<int>(0);
+
+    for (int round = 0; round < 100; ++round) {
+        Context local;
+        for (int i = 0; i < 20; ++i) {
+            local.setGlobalFunction("fn" + std::to_string(i), [sentinel, &local](const std::vector<QuickJSWrapper::Value>&) -> QuickJSWrapper::Value {
+                return local.newInt32(*sentinel + 1);
+            });
+        }
+        EXPECT_EQ(local.eval("fn0() + fn19()").toInt32(), 2);
+    }
+
+    EXPECT_EQ(sentinel.use_count(), 1);
+}
+
+// Validates that contexts on separate threads dispatch native calls without shared state
+TEST_F(NativeBindingsTest, ConcurrentContextsOnSeparateThreads) {
+    const int threadCount = 8;
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([t, &failures]() {
+            try {
+                Context local;
+                for (int i = 0; i < 50; ++i) {
+                    local.setGlobalFunction("fn" + std::to_string(i), [&local, t, i](const std::vector<QuickJSWrapper::Value>& args) -> QuickJSWrapper::Value {
+                        return local.newInt32(args[0].toInt32() + t * 100 + i);
+                    });
+                }
+                auto result = local.eval(R"(
+                    var total = 0;
+                    for (var n = 0; n < 1000; n++) {
+                        total += fn49(1) - fn0(1);
+                    }
+                    total;
+                )");
+                if (result.toInt32() != 49 * 1000) {
+                    failures++;
+                }
+            } catch (const Exception&) {
+                failures++;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+}
+
+// Validates that a compile-time bound function converts arguments and declares its arity
+TEST_F(NativeBindingsTest, TypedStaticFunctionBinding) {
+    ctx->bindGlobalFunction<&addNumbers>("add");
+    ctx->bindGlobalFunction<&repeatText>("repeat");
+
+    EXPECT_DOUBLE_EQ(ctx->eval("add(1.5, 2)").toNumber(), 3.5);
+    EXPECT_EQ(ctx->eval("add.length").toInt32(), 2);
+    EXPECT_EQ(ctx->eval("add.name").toString(), "add");
+    EXPECT_EQ(ctx->eval("repeat('ab', 3)").toString(), "ababab");
+
+    // Missing arguments arrive as undefined
+    EXPECT_TRUE(ctx->eval("isNaN(add(1))").toBool());
+}
+
+// Validates that capturing callables are bound with typed arguments and results
+TEST_F(NativeBindingsTest, TypedCallableBinding) {
+    int calls = 0;
+    std::string lastMessage;
+
+    ctx->bindGlobalFunction("twice", [&calls](int32_t x) {
+        ++calls;
+        return x * 2;
+    });
+    ctx->bindGlobalFunction("record", [&lastMessage](const std::string& message) {
+        lastMessage = message;
+    });
+    ctx->bindGlobalFunction("isList", [](QuickJSWrapper::Value value) {
+        return value.isArray();
+    });
+
+    EXPECT_EQ(ctx->eval("twice(21)").toInt32(), 42);
+    EXPECT_EQ(calls, 1);
+
+    EXPECT_TRUE(ctx->eval("record('hello') === undefined").toBool());
+    EXPECT_EQ(lastMessage, "hello");
+
+    EXPECT_TRUE(ctx->eval("isList([1, 2])").toBool());
+    EXPECT_FALSE(ctx->eval("isList({})").toBool());
+}
+
+// Validates that conversion failures and C++ exceptions surface as JavaScript errors
+TEST_F(NativeBindingsTest, TypedBindingErrorPropagation) {
+    ctx->bindGlobalFunction<&addNumbers>("add");
+    ctx->bindGlobalFunction("fail", [](int32_t) -> int32_t {
+        throw Exception("native failure");
+    });
+
+    EXPECT_THROW(ctx->eval("add(Symbol('x'), 1)"), Exception);
+
+    auto message = ctx->eval(R"(
+        var caught = '';
+        try { fail(1); } catch (e) { caught = e.message; }
+        caught;
+    )");
+    EXPECT_EQ(message.toString(), "native failure");
+
+    // Context should still be functional
+    EXPECT_DOUBLE_EQ(ctx->eval("add(2, 3)").toNumber(), 5.0);
+}
@@ -0,0 +1,485 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include "quickjs_snapshot.h"
+#include "quickjs_executor.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Benchmarks comparing wrapper fast paths against their generic counterparts
+class PerformanceTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+    }
+
+    void TearDown() override {
+        ctx.reset();
+    }
+
+    template <typename F>
+    static double measureMs(F&& body) {
+        auto start = std::chrono::high_resolution_clock::now();
+        body();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    std::unique_ptr<Context> ctx;
+};
+
+// Benchmark: property reads by string name versus pre-interned PropertyKey
+TEST_F(PerformanceTest, PropertyKeyVersusStringAccess) {
+    const int objectCount = 1000;
+    const int fieldCount = 20;
+    const int rounds = 20;
+
+    ctx->eval(R"(
+        var records = [];
+        for (var i = 0; i < 1000; i++) {
+            var record = {};
+            for (var f = 0; f < 20; f++) {
+                record['field' + f] = i + f;
+            }
+            records.push(record);
+        }
+    )");
+    auto records = ctx->getGlobalProperty("records");
+    std::vector<QuickJSWrapper::Value> objects;
+    objects.reserve(objectCount);
+    for (int i = 0; i < objectCount; ++i) {
+        objects.push_back(records.getElement(i));
+    }
+
+    std::vector<std::string> names;
+    std::vector<PropertyKey> keys;
+    for (int f = 0; f < fieldCount; ++f) {
+        names.push_back("field" + std::to_string(f));
+        keys.push_back(ctx->newPropertyKey(names.back()));
+    }
+
+    double stringSum = 0;
+    double stringMs = measureMs([&]() {
+        for (int r = 0; r < rounds; ++r) {
+            for (const auto& obj : objects) {
+                for (const auto& name : names) {
+                    stringSum += obj.getProperty(name).toNumber();
+                }
+            }
+        }
+    });
+
+    double keySum = 0;
+    double keyMs = measureMs([&]() {
+        for (int r = 0; r < rounds; ++r) {
+            for (const auto& obj : objects) {
+                for (const auto& key : keys) {
+                    keySum += obj.getProperty(key).toNumber();
+                }
+            }
+        }
+    });
+
+    EXPECT_DOUBLE_EQ(stringSum, keySum);
+
+    const double accesses = static_cast<double>(rounds) * objectCount * fieldCount;
+    std::cout << "String name access: " << (stringMs * 1e6 / accesses) << " ns/access" << std::endl;
+    std::cout << "PropertyKey access: " << (keyMs * 1e6 / accesses) << " ns/access" << std::endl;
+    std::cout << "Saving per access: " << ((stringMs - keyMs) * 1e6 / accesses) << " ns" << std::endl;
+}
+
+// Benchmark: repeated eval of the same source versus running a compiled Script
+TEST_F(PerformanceTest, CompiledScriptVersusEval) {
+    const int iterations = 2000;
+    const std::string source = R"(
+        (function() {
+            var request = { path: '/api/items', method: 'GET', headers: { accept: 'json' } };
+            function route(req) {
+                switch (req.method) {
+                    case 'GET': return 'read:' + req.path;
+                    case 'POST': return 'write:' + req.path;
+                    default: return 'unknown';
+                }
+            }
+            var total = 0;
+            for (var i = 0; i < 10; i++) {
+                total += route(request).length;
+            }
+            return total;
+        })();
+    )";
+
+    double evalTotal = 0;
+    double evalMs = measureMs([&]() {
+        for (int i = 0; i < iterations; ++i) {
+            evalTotal += ctx->eval(source, "handler.js").toNumber();
+        }
+    });
+
+    auto script = ctx->compile(source, "handler.js");
+    double runTotal = 0;
+    double runMs = measureMs([&]() {
+        for (int i = 0; i < iterations; ++i) {
+            runTotal += script.run().toNumber();
+        }
+    });
+
+    EXPECT_DOUBLE_EQ(evalTotal, runTotal);
+
+    std::cout << "eval: " << (evalMs * 1000.0 / iterations) << " us/run" << std::endl;
+    std::cout << "compiled run: " << (runMs * 1000.0 / iterations) << " us/run" << std::endl;
+}
+
+// Benchmark: context startup by running the init script versus materializing a snapshot
+TEST_F(PerformanceTest, SnapshotVersusInitScriptStartup) {
+    const int startups = 20;
+    const std::string initScript = R"(
+        var catalog = [];
+        for (var i = 0; i < 20000; i++) {
+            catalog.push({ sku: 'SKU-' + i, price: (i * 37) % 1000 / 10, tags: ['t' + (i % 7), 't' + (i % 11)] });
+        }
+        var index = {};
+        for (var i = 0; i < catalog.length; i++) {
+            index[catalog[i].sku] = i;
+        }
+    )";
+
+    double scriptMs = measureMs([&]() {
+        for (int i = 0; i < startups; ++i) {
+            Context fresh;
+            fresh.eval(initScript, "init.js");
+        }
+    });
+
+    auto snapshot = ContextSnapshot::capture(initScript, "init.js");
+    ASSERT_FALSE(snapshot.requiresReplay());
+    double snapshotMs = measureMs([&]() {
+        for (int i = 0; i < startups; ++i) {
+            auto restored = snapshot.instantiate();
+        }
+    });
+
+    auto check = snapshot.instantiate();
+    EXPECT_EQ(check->eval("catalog[index['SKU-123']].sku").toString(), "SKU-123");
+
+    std::cout << "Init script startup: " << (scriptMs / startups) << " ms/context" << std::endl;
+    std::cout << "Snapshot startup: " << (snapshotMs / startups) << " ms/context" << std::endl;
+}
+
+// Benchmark: job throughput of a single-worker executor versus one worker per core
+TEST_F(PerformanceTest, ExecutorScaling) {
+    const int jobs = 400;
+    auto runJobs = [&](size_t threads) {
+        ExecutorOptions options;
+        options.threads = threads;
+        options.initializer = [](Context& c) {
+            c.eval("function work(n) { var s = 0; for (var i = 0; i < n; i++) s += i % 7; return s; }");
+        };
+        Executor executor(options);
+        auto argument = ctx->newInt32(20000).serialize();
+
+        std::vector<std::future<std::vector<uint8_t>>> results;
+        results.reserve(jobs);
+        double ms = measureMs([&]() {
+            for (int i = 0; i < jobs; ++i) {
+                ScriptJob job;
+                job.function = "work";
+                job.args.push_back(argument);
+                results.push_back(executor.submit(std::move(job)));
+            }
+            for (auto& result : results) {
+                result.get();
+            }
+        });
+        EXPECT_EQ(executor.getMetrics().completed, static_cast<size_t>(jobs));
+        return ms;
+    };
+
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    double singleMs = runJobs(1);
+    double parallelMs = runJobs(cores);
+
+    std::cout << "Executor, 1 worker: " << singleMs << " ms for " << jobs << " jobs" << std::endl;
+    std::cout << "Executor, " << cores << " workers: " << parallelMs << " ms for " << jobs << " jobs" << std::endl;
+}
+
+// Benchmark: allocation-heavy request workload on the default allocator, the size-class pool and a per-request arena
+TEST_F(PerformanceTest, AllocatorComparison) {
+    const int requests = 30;
+    const std::string workload = R"(
+        var objects = [];
+        for (var i = 0; i < 20000; i++) {
+            objects.push({
+                id: i,
+                data: 'object_data_' + i,
+                nested: { value: i * 2, array: [1, 2, 3, 4, 5] }
+            });
+        }
+        var strings = [];
+        for (var j = 0; j < 5000; j++) {
+            strings.push('x'.repeat(j % 100) + j);
+        }
+        objects.length + strings.length;
+    )";
+
+    auto runRequests = [&](const std::function<std::shared_ptr<Allocator>()>& allocatorFor,
+                           const std::function<void()>& afterRequest) {
+        return measureMs([&]() {
+            for (int i = 0; i < requests; ++i) {
+                {
+                    Context request(allocatorFor());
+                    EXPECT_EQ(request.eval(workload).toInt32(), 25000);
+                }
+                afterRequest();
+            }
+        });
+    };
+
+    double defaultMs = runRequests([]() { return std::shared_ptr<Allocator>(); }, []() {});
+    auto pool = std::make_shared<PoolAllocator>();
+    double poolMs = runRequests([&]() { return pool; }, []() {});
+    auto arena = std::make_shared<ArenaAllocator>(4 * 1024 * 1024);
+    double arenaMs = runRequests([&]() { return arena; }, [&]() { arena->reset(); });
+
+    std::cout << "Default malloc: " << (defaultMs / requests) << " ms/request" << std::endl;
+    std::cout << "Pool allocator: " << (poolMs / requests) << " ms/request" << std::endl;
+    std::cout << "Arena allocator: " << (arenaMs / requests) << " ms/request" << std::endl;
+}
+
+// Benchmark: counter-based memory usage versus the full heap walk
+TEST_F(PerformanceTest, MemoryUsageCountersVersusHeapWalk) {
+    const int reads = 2000;
+    ctx->eval(R"(
+        var retained = [];
+        for (var i = 0; i < 50000; i++) {
+            retained.push({ id: i, label: 'entry_' + i });
+        }
+    )");
+
+    size_t counterSum = 0;
+    double counterMs = measureMs([&]() {
+        for (int i = 0; i < reads; ++i) {
+            counterSum += ctx->getMemoryUsage();
+        }
+    });
+
+    int64_t walkSum = 0;
+    double walkMs = measureMs([&]() {
+        for (int i = 0; i < reads; ++i) {
+            walkSum += ctx->computeMemoryUsage().memory_used_size;
+        }
+    });
+
+    EXPECT_GT(counterSum, 0u);
+    EXPECT_GT(walkSum, 0);
+    std::cout << "getMemoryUsage (counters): " << counterMs << " ms for " << reads << " reads" << std::endl;
+    std::cout << "computeMemoryUsage (heap walk): " << walkMs << " ms for " << reads << " reads" << std::endl;
+}
+
+// Benchmark: bulk numeric exchange through typed arrays versus element-wise access
+TEST_F(PerformanceTest, TypedArrayVersusElementwise) {
+    const size_t count = 1000000;
+    std::vector<double> input(count);
+    for (size_t i = 0; i < count; ++i) {
+        input[i] = static_cast<double>(i) * 0.5;
+    }
+    auto sum = ctx->eval("(function (values) { var total = 0; for (var i = 0; i < values.length; i++) total += values[i]; return total; })");
+
+    double elementSum = 0;
+    double elementMs = measureMs([&]() {
+        auto array = ctx->newArray();
+        for (size_t i = 0; i < count; ++i) {
+            array.setElement(static_cast<int>(i), ctx->newNumber(input[i]));
+        }
+        elementSum = sum.call({array}).toNumber();
+
+        auto output = ctx->eval("(function () { var out = []; for (var i = 0; i < 1000000; i++) out.push(i); return out; })()");
+        size_t length = output.getArrayLength();
+        for (size_t i = 0; i < length; ++i) {
+            elementSum += output.getElement(static_cast<int>(i)).toNumber();
+        }
+    });
+
+    double typedSum = 0;
+    double typedMs = measureMs([&]() {
+        typedSum = sum.call({ctx->newTypedArray(Span<const double>(input))}).toNumber();
+
+        auto output = ctx->eval("(function () { var out = new Float64Array(1000000); for (var i = 0; i < out.length; i++) out[i] = i; return out; })()");
+        for (double value : output.asSpan<const double>()) {
+            typedSum += value;
+        }
+    });
+
+    EXPECT_DOUBLE_EQ(elementSum, typedSum);
+    std::cout << "Element-wise exchange of " << count << " numbers each way: " << elementMs << " ms" << std::endl;
+    std::cout << "Typed array exchange of " << count << " numbers each way: " << typedMs << " ms" << std::endl;
+}
+
+// Benchmark: passing values around by owning copy versus borrowed ValueRef
+TEST_F(PerformanceTest, ValueCopyVersusValueRef) {
+    const int count = 1000;
+    const int rounds = 200;
+    std::vector<QuickJSWrapper::Value> items;
+    for (int i = 0; i < count; ++i) {
+        items.push_back(ctx->eval("({ weight: " + std::to_string(i) + " })"));
+    }
+    auto weight = ctx->newPropertyKey("weight");
+    auto isHeavy = [&weight](QuickJSWrapper::Value item) { return item.getProperty(weight).toInt32() >= 500; };
+    auto isHeavyRef = [&weight](ValueRef item) { return item.getProperty(weight).toInt32() >= 500; };
+
+    int copyHeavy = 0;
+#ifdef QUICKJS_WRAPPER_REFCOUNT_STATS
+    resetRefcountStats();
+#endif
+    double copyMs = measureMs([&]() {
+        for (int r = 0; r < rounds; ++r) {
+            for (const auto& item : items) {
+                copyHeavy += isHeavy(item);
+            }
+        }
+    });
+#ifdef QUICKJS_WRAPPER_REFCOUNT_STATS
+    auto copyStats = getRefcountStats();
+    resetRefcountStats();
+#endif
+
+    int refHeavy = 0;
+    double refMs = measureMs([&]() {
+        for (int r = 0; r < rounds; ++r) {
+            for (const auto& item : items) {
+                refHeavy += isHeavyRef(item);
+            }
+        }
+    });
+
+    const double operations = static_cast<double>(count) * rounds;
+    EXPECT_EQ(copyHeavy, refHeavy);
+    std::cout << "Value copy: " << (copyMs * 1e6 / operations) << " ns/op" << std::endl;
+    std::cout << "ValueRef: " << (refMs * 1e6 / operations) << " ns/op" << std::endl;
+#ifdef QUICKJS_WRAPPER_REFCOUNT_STATS
+    auto refStats = getRefcountStats();
+    // Each op still frees the property it reads; the copy adds a dup/free pair
+    EXPECT_EQ(copyStats.dups - refStats.dups, static_cast<size_t>(count) * rounds);
+    std::cout << "Value copy: " << (copyStats.dups / operations) << " dups, "
+              << (copyStats.frees / operations) << " frees per op" << std::endl;
+    std::cout << "ValueRef: " << (refStats.dups / operations) << " dups, "
+              << (refStats.frees / operations) << " frees per op" << std::endl;
+#endif
+}
+
+// Benchmark: walking an object graph with individual Values versus a HandleScope
+TEST_F(PerformanceTest, HandleScopeTraversal) {
+    ctx->eval(R"(
+        function build(depth) {
+            if (depth === 0) return { weight: 1, children: [] };
+            return { weight: depth, children: [build(depth - 1), build(depth - 1), build(depth - 1)] };
+        }
+        var graph = build(8);
+    )");
+    auto graph = ctx->getGlobalProperty("graph");
+    auto weight = ctx->newPropertyKey("weight");
+    auto children = ctx->newPropertyKey("children");
+    const int rounds = 10;
+
+    std::function<int64_t(const QuickJSWrapper::Value&)> sumValues = [&](const QuickJSWrapper::Value& node) {
+        int64_t total = node.getProperty(weight).toInt32();
+        auto list = node.getProperty(children);
+        size_t count = list.getArrayLength();
+        for (size_t i = 0; i < count; ++i) {
+            total += sumValues(list.getElement(static_cast<int>(i)));
+        }
+        return total;
+    };
+    int64_t valueTotal = 0;
+    double valueMs = measureMs([&]() {
+        for (int r = 0; r < rounds; ++r) {
+            valueTotal = sumValues(graph);
+        }
+    });
+
+    int64_t scopeTotal = 0;
+    size_t handles = 0;
+    double scopeMs = measureMs([&]() {
+        for (int r = 0; r < rounds; ++r) {
+            HandleScope scope(*ctx);
+            std::function<int64_t(ValueRef)> sumHandles = [&](ValueRef node) {
+                int64_t total = scope.getProperty(node, weight).toInt32();
+                ValueRef list = scope.getProperty(node, children);
+                size_t count = list.getArrayLength();
+                for (size_t i = 0; i < count; ++i) {
+                    total += sumHandles(scope.getElement(list, static_cast<uint32_t>(i)));
+                }
+                return total;
+            };
+            scopeTotal = sumHandles(graph);
+            handles = scope.size();
+        }
+    });
+
+    EXPECT_EQ(valueTotal, scopeTotal);
+    std::cout << "Individual Values: " << (valueMs / rounds) << " ms/walk" << std::endl;
+    std::cout << "HandleScope (" << handles << " handles): " << (scopeMs / rounds) << " ms/walk" << std::endl;
+}
+
+// Benchmark: reading strings by copy versus through a StringView
+TEST_F(PerformanceTest, StringViewVersusToString) {
+    auto text = ctx->eval("'x'.repeat(4096)");
+    const int reads = 20000;
+
+    size_t copied = 0;
+    double copyMs = measureMs([&]() {
+        for (int i = 0; i < reads; ++i) {
+            copied += text.toString().size();
+        }
+    });
+
+    size_t viewed = 0;
+    double viewMs = measureMs([&]() {
+        for (int i = 0; i < reads; ++i) {
+            viewed += text.toStringView().size();
+        }
+    });
+
+    EXPECT_EQ(copied, viewed);
+    std::cout << "toString: " << (copyMs * 1000.0 / reads) << " us/read" << std::endl;
+    std::cout << "toStringView: " << (viewMs * 1000.0 / reads) << " us/read" << std::endl;
+}
+
+// Benchmark: repeated constant strings through the cache versus plain newString
+TEST_F(PerformanceTest, CachedStringVersusNewString) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 300; ++i) {
+        names.push_back("field_name_" + std::to_string(i));
+    }
+    const int requests = 1000;
+
+    double plainMs = measureMs([&]() {
+        for (int r = 0; r < requests; ++r) {
+            for (const auto& name : names) {
+                ctx->newString(name);
+            }
+        }
+    });
+
+    double cachedMs = measureMs([&]() {
+        for (int r = 0; r < requests; ++r) {
+            for (const auto& name : names) {
+                ctx->newCachedString(name);
+            }
+        }
+    });
+
+    auto stats = ctx->getStringCacheStats();
+    const double strings = static_cast<double>(requests) * names.size();
+    EXPECT_EQ(stats.misses, names.size());
+    std::cout << "newString: " << (plainMs * 1e6 / strings) << " ns/string" << std::endl;
+    std::cout << "newCachedString: " << (cachedMs * 1e6 / strings) << " ns/string, hit rate "
+              << (100.0 * stats.hits / (stats.hits + stats.misses)) << "%" << std::endl;
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating the persistent handle table
+class PersistentHandleTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+    }
+
+    void TearDown() override {
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+};
+
+// Validates that a cached callback outlives its script-side references
+TEST_F(PersistentHandleTest, CachedCallback) {
+    ctx->eval("var onRequest = function (path) { return 'handled ' + path; };");
+    std::map<std::string, PersistentHandle> routes;
+    routes["/"] = ctx->persist(ctx->getGlobalProperty("onRequest"));
+
+    ctx->eval("onRequest = null;");
+    ctx->runGC();
+
+    auto handler = ctx->getPersistent(routes["/"]);
+    EXPECT_EQ(handler.call({ctx->newString("/index")}).toString(), "handled /index");
+    EXPECT_EQ(ctx->getPersistentRef(routes["/"]).call({ctx->newString("/a")}).toString(), "handled /a");
+    EXPECT_EQ(ctx->getPersistentHandleStats().live, 1u);
+}
+
+// Validates that released and reused slots reject stale handles
+TEST_F(PersistentHandleTest, GenerationChecks) {
+    auto first = ctx->persist(ctx->newString("first"));
+    EXPECT_NE(first.generation, 0u);
+    EXPECT_TRUE(ctx->isPersistentAlive(first));
+
+    EXPECT_TRUE(ctx->releasePersistent(first));
+    EXPECT_FALSE(ctx->releasePersistent(first));
+    EXPECT_FALSE(ctx->isPersistentAlive(first));
+    EXPECT_THROW(ctx->getPersistent(first), Exception);
+
+    // The slot is reused under a new generation
+    auto second = ctx->persist(ctx->newString("second"));
+    EXPECT_EQ(second.index, first.index);
+    EXPECT_NE(second, first);
+    EXPECT_THROW(ctx->getPersistentRef(first), Exception);
+    EXPECT_EQ(ctx->getPersistent(second).toString(), "second");
+
+    EXPECT_FALSE(ctx->isPersistentAlive(PersistentHandle{}));
+    EXPECT_FALSE(ctx->isPersistentAlive(PersistentHandle{1000, 1}));
+}
+
+// Validates the live handle metric and bulk release
+TEST_F(PersistentHandleTest, StatsAndBulkRelease) {
+    ctx->runGC();
+    size_t baseline = ctx->getMemoryUsage();
+
+    std::vector<PersistentHandle> handles;
+    for (int i = 0; i < 1000; ++i) {
+        handles.push_back(ctx->persist(ctx->eval("({ payload: 'x'.repeat(64) + " + std::to_string(i) + " })")));
+    }
+    for (int i = 0; i < 400; ++i) {
+        ctx->releasePersistent(handles[i]);
+    }
+
+    auto stats = ctx->getPersistentHandleStats();
+    EXPECT_EQ(stats.live, 600u);
+    EXPECT_EQ(stats.peak, 1000u);
+    EXPECT_EQ(stats.created, 1000u);
+    EXPECT_EQ(stats.released, 400u);
+
+    ctx->releaseAllPersistent();
+    ctx->runGC();
+    EXPECT_EQ(ctx->getPersistentHandleStats().live, 0u);
+    EXPECT_FALSE(ctx->isPersistentAlive(handles.back()));
+    EXPECT_LT(ctx->getMemoryUsage(), baseline + 64 * 1024);
+}
+
+// Validates that handles stay valid across a move and are freed with the context
+TEST_F(PersistentHandleTest, ContextLifetime) {
+    auto handle = ctx->persist(ctx->eval("({ id: 7 })"));
+    Context moved(std::move(*ctx));
+    EXPECT_EQ(moved.getPersistent(handle).getProperty("id").toInt32(), 7);
+    EXPECT_EQ(moved.getPersistentHandleStats().live, 1u);
+
+    // Destroying a context with live handles releases them
+    auto local = std::make_unique<Context>();
+    local->persist(local->newObject());
+    local->persist(local->newArray());
+    EXPECT_NO_THROW(local.reset());
+}
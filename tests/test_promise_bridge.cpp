@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_event_loop.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#endif
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating promise bridging between JavaScript and C++ threads
+class PromiseBridgeTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+        loop = std::make_unique<EventLoop>(*ctx);
+    }
+
+    void TearDown() override {
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        loop.reset();
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+    std::unique_ptr<EventLoop> loop;
+    std::vector<std::thread> workers;
+};
+
+// Validates awaiting async functions, timers and rejections from C++
+TEST_F(PromiseBridgeTest, AwaitAsyncResults) {
+    auto result = ctx->eval(R"(
+        async function twice(x) {
+            await new Promise(function (resolve) { setTimeout(resolve, 5); });
+            return x * 2;
+        }
+        twice(21);
+    )");
+    EXPECT_EQ(loop->await(result).toInt32(), 42);
+
+    // Plain values and already settled promises complete at once
+    EXPECT_EQ(loop->await(ctx->newInt32(7)).toInt32(), 7);
+    EXPECT_EQ(loop->await(ctx->eval("Promise.resolve('ready')")).toString(), "ready");
+
+    try {
+        loop->await(ctx->eval("(async function () { throw new Error('broken'); })()"));
+        FAIL() << "rejection should throw";
+    } catch (const Exception& e) {
+        EXPECT_THAT(e.what(), HasSubstr("broken"));
+    }
+
+    // Nothing left to run can settle this one
+    EXPECT_THROW(loop->await(ctx->eval("new Promise(function () {})")), Exception);
+}
+
+// Validates that a future becomes ready as the loop runs the promise jobs
+TEST_F(PromiseBridgeTest, FutureSettlesAsLoopRuns) {
+    auto future = loop->toFuture(ctx->eval("Promise.resolve(5).then(function (v) { return v + 1; })"));
+    EXPECT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+
+    loop->run();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_EQ(future.get().toInt32(), 6);
+
+    auto rejected = loop->toFuture(ctx->eval("Promise.reject(new TypeError('bad input'))"));
+    loop->run();
+    EXPECT_THROW(rejected.get(), Exception);
+}
+
+// Validates that native functions resolved from worker threads overlap on one context
+TEST_F(PromiseBridgeTest, NativeFunctionsResolvedFromWorkerThreads) {
+    const int requests = 40;
+    const auto latency = std::chrono::milliseconds(20);
+    std::mutex workersMutex;
+
+    ctx->setGlobalFunction("fetchValue", [&](const std::vector<QuickJSWrapper::Value>& args) -> QuickJSWrapper::Value {
+        int input = args[0].toInt32();
+        auto [promise, resolver] = loop->newPromise();
+        std::lock_guard<std::mutex> lock(workersMutex);
+        workers.emplace_back([resolver = resolver, input, latency]() mutable {
+            std::this_thread::sleep_for(latency);
+            resolver.resolve(input * 2);
+        });
+        return promise;
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    auto total = ctx->eval(R"(
+        var pending = [];
+        for (var i = 0; i < 40; i++) {
+            pending.push(fetchValue(i));
+        }
+        Promise.all(pending).then(function (values) {
+            return values.reduce(function (a, b) { return a + b; }, 0);
+        });
+    )");
+    EXPECT_EQ(loop->pendingPromises(), static_cast<size_t>(requests));
+
+    EXPECT_EQ(loop->await(total).toInt32(), requests * (requests - 1));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, latency * (requests / 2));
+    EXPECT_EQ(loop->pendingPromises(), 0u);
+}
+
+// Validates rejection, abandonment and building values on the loop thread
+TEST_F(PromiseBridgeTest, ResolverSettlements) {
+    auto loopThread = std::this_thread::get_id();
+    std::atomic<bool> builtOnLoopThread{false};
+
+    auto first = loop->newPromise();
+    auto second = loop->newPromise();
+    auto third = loop->newPromise();
+    ctx->setGlobalProperty("first", first.promise);
+    ctx->setGlobalProperty("second", second.promise);
+    ctx->setGlobalProperty("third", third.promise);
+    ctx->eval(R"(
+        var outcomes = [];
+        first.then(function (v) { outcomes.push('first:' + v.name); });
+        second.catch(function (e) { outcomes.push('second:' + e.message); });
+        third.catch(function (e) { outcomes.push('third:' + (e instanceof Error)); });
+    )");
+
+    workers.emplace_back([&, resolver = first.resolver]() mutable {
+        resolver.resolveWith([&](Context& context) {
+            builtOnLoopThread = std::this_thread::get_id() == loopThread;
+            auto object = context.newObject();
+            object.setProperty("name", context.newString("built"));
+            return object;
+        });
+        // Later settlements are ignored
+        resolver.reject("too late");
+    });
+    workers.emplace_back([resolver = second.resolver]() mutable {
+        resolver.reject("no data");
+    });
+    // Dropping the last copy rejects the promise
+    { auto abandoned = std::move(third.resolver); }
+
+    loop->run();
+    EXPECT_TRUE(builtOnLoopThread);
+    EXPECT_EQ(ctx->eval("outcomes.sort().join(',')").toString(),
+              "first:built,second:no data,third:true");
+}
+
+// Validates that tasks posted from other threads run on the loop and wake a poller
+TEST_F(PromiseBridgeTest, PostedTasksRunOnLoop) {
+    std::atomic<int> ran{0};
+    auto [promise, resolver] = loop->newPromise();
+
+    workers.emplace_back([&, resolver = resolver]() mutable {
+        for (int i = 0; i < 100; ++i) {
+            loop->post([&ran]() { ran++; });
+        }
+        resolver.resolve("posted");
+    });
+
+#ifdef __linux__
+    ASSERT_GE(loop->fd(), 0);
+    pollfd pfd{loop->fd(), POLLIN, 0};
+    ASSERT_EQ(poll(&pfd, 1, 1000), 1);
+#endif
+
+    EXPECT_EQ(loop->await(promise).toString(), "posted");
+    EXPECT_EQ(ran.load(), 100);
+}
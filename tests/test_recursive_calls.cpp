@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "quickjs_wrapper.h"
+#include "quickjs_event_loop.h"
 #include <atomic>
 #include <chrono>
 
@@ -291,32 +292,29 @@ TEST_F(RecursiveCallsTest, RecursiveTryCatchSafety) {
     }, Exception);
 }
 
-// Validates QuickJS safely manages recursive timer patterns (if supported)
+// Validates QuickJS safely manages recursive timer patterns driven by the event loop
 TEST_F(RecursiveCallsTest, RecursiveTimerSafety) {
-    try {
-        // This might not work if timers aren't implemented
-        ctx->eval(R"(
-            var timerCount = 0;
-            var maxTimers = 1000;
+    EventLoop loop(*ctx);
+    ctx->eval(R"(
+        var timerCount = 0;
+        var maxTimers = 1000;
+        
+        function recursiveTimer() {
+            timerCount++;
             
-            function recursiveTimer() {
-                timerCount++;
-                
-                if (timerCount >= maxTimers) {
-                    throw new Error("Timer overflow");
-                }
-                
-                setTimeout(recursiveTimer, 0);
+            if (timerCount >= maxTimers) {
+                throw new Error("Timer overflow");
             }
-        )");
-        
-        EXPECT_THROW({
-            auto result = ctx->eval("recursiveTimer()");
-        }, Exception);
-        
-    } catch (const Exception& e) {
-        GTEST_SKIP() << "Timers not supported: " << e.what();
-    }
+            
+            setTimeout(recursiveTimer, 0);
+        }
+    )");
+    
+    // Each callback schedules the next one, so the chain never deepens the stack
+    ctx->eval("recursiveTimer()");
+    EXPECT_THROW(loop.run(), Exception);
+    EXPECT_EQ(ctx->eval("timerCount").toInt32(), 1000);
+    EXPECT_EQ(loop.pendingTimers(), 0u);
 }
 
 // Validates QuickJS safely handles recursive property accessor patterns
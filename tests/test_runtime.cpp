@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating many lightweight contexts sharing one runtime
+class RuntimeTest : public Test {
+protected:
+    void SetUp() override {
+        runtime = std::make_shared<Runtime>();
+    }
+
+    void TearDown() override {
+        runtime.reset();
+    }
+
+    std::shared_ptr<Runtime> runtime;
+};
+
+// Validates that contexts on a shared runtime keep separate global scopes
+TEST_F(RuntimeTest, ContextsShareRuntimeWithIsolatedGlobals) {
+    Context tenantA(runtime);
+    Context tenantB(runtime);
+    EXPECT_EQ(tenantA.getJSRuntime(), tenantB.getJSRuntime());
+    EXPECT_EQ(tenantA.getRuntime(), runtime);
+
+    tenantA.eval("var secret = 'a';");
+    tenantB.eval("var secret = 'b';");
+    EXPECT_EQ(tenantA.eval("secret").toString(), "a");
+    EXPECT_EQ(tenantB.eval("secret").toString(), "b");
+
+    tenantA.eval("Array.prototype.tampered = true;");
+    EXPECT_TRUE(tenantB.eval("[].tampered === undefined").toBool());
+}
+
+// Validates that native functions and property keys work across contexts of one runtime
+TEST_F(RuntimeTest, NativeFunctionsAndKeysOnSharedRuntime) {
+    Context first(runtime);
+    Context second(runtime);
+
+    first.bindGlobalFunction("tag", [](int32_t x) { return x + 1000; });
+    second.bindGlobalFunction("tag", [](int32_t x) { return x + 2000; });
+    EXPECT_EQ(first.eval("tag(1)").toInt32(), 1001);
+    EXPECT_EQ(second.eval("tag(1)").toInt32(), 2001);
+
+    // Atoms belong to the runtime, so a key interned once serves every context
+    auto key = first.newPropertyKey("shared");
+    auto obj = second.newObject();
+    obj.setProperty(key, second.newInt32(5));
+    EXPECT_EQ(obj.getProperty(key).toInt32(), 5);
+}
+
+// Validates that contexts keep their runtime alive after other owners release it
+TEST_F(RuntimeTest, ContextsKeepRuntimeAlive) {
+    std::weak_ptr<Runtime> watcher = runtime;
+    auto context = std::make_unique<Context>(runtime);
+    runtime.reset();
+
+    EXPECT_FALSE(watcher.expired());
+    EXPECT_EQ(context->eval("40 + 2").toInt32(), 42);
+
+    Context moved = std::move(*context);
+    context.reset();
+    EXPECT_FALSE(watcher.expired());
+    EXPECT_EQ(moved.eval("1 + 1").toInt32(), 2);
+}
+
+// Validates that a shared runtime is cheaper than one runtime per tenant
+TEST_F(RuntimeTest, SharedRuntimeMemoryFootprint) {
+    const int tenantCount = 20;
+
+    std::vector<std::unique_ptr<Context>> shared;
+    for (int i = 0; i < tenantCount; ++i) {
+        shared.push_back(std::make_unique<Context>(runtime));
+    }
+    size_t sharedUsage = runtime->getMemoryUsage();
+
+    std::vector<std::unique_ptr<Context>> separate;
+    size_t separateUsage = 0;
+    for (int i = 0; i < tenantCount; ++i) {
+        separate.push_back(std::make_unique<Context>());
+        separateUsage += separate.back()->getMemoryUsage();
+    }
+
+    EXPECT_LT(sharedUsage, separateUsage);
+    std::cout << tenantCount << " contexts on one runtime: " << sharedUsage << " bytes" << std::endl;
+    std::cout << tenantCount << " contexts on own runtimes: " << separateUsage << " bytes" << std::endl;
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include "quickjs_wrapper_test_scripts.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating compiled script reuse
+class ScriptTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+    }
+
+    void TearDown() override {
+        ctx.reset();
+        if (!workDir.empty()) {
+            std::error_code ec;
+            std::filesystem::remove_all(workDir, ec);
+        }
+    }
+
+    // Creates a scratch directory removed in TearDown
+    std::filesystem::path makeWorkDir() {
+        workDir = std::filesystem::temp_directory_path() /
+            ("quickjs_wrapper_scripts_" +
+             std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        std::filesystem::create_directories(workDir);
+        return workDir;
+    }
+
+    static void writeFile(const std::filesystem::path& path, const std::string& content) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << content;
+    }
+
+    std::unique_ptr<Context> ctx;
+    std::filesystem::path workDir;
+};
+
+// Validates that a compiled script can be run repeatedly against the same globals
+TEST_F(ScriptTest, CompileOnceRunMany) {
+    ctx->eval("var counter = 0;");
+    auto script = ctx->compile("counter += 1; counter * 10;", "counter.js");
+
+    // Compiling alone does not execute anything
+    EXPECT_EQ(ctx->eval("counter").toInt32(), 0);
+
+    for (int i = 1; i <= 100; ++i) {
+        auto result = script.run();
+        EXPECT_EQ(result.toInt32(), i * 10);
+    }
+    EXPECT_EQ(ctx->eval("counter").toInt32(), 100);
+}
+
+// Validates that copies of a script share the compiled bytecode
+TEST_F(ScriptTest, ScriptCopiesAndMoves) {
+    auto script = ctx->compile("typeof helper === 'function' ? helper() : 'missing'");
+    ctx->eval("function helper() { return 'found'; }");
+
+    Script copy = script;
+    Script moved = std::move(script);
+    EXPECT_EQ(copy.run().toString(), "found");
+    EXPECT_EQ(moved.run().toString(), "found");
+    EXPECT_THROW(script.run(), Exception);
+}
+
+// Validates that syntax errors are reported at compile time and runtime errors at run time
+TEST_F(ScriptTest, CompileAndRuntimeErrors) {
+    EXPECT_THROW(ctx->compile("var x = ;"), Exception);
+
+    auto failing = ctx->compile("undefinedFunction()");
+    EXPECT_THROW(failing.run(), Exception);
+    EXPECT_THROW(failing.run(), Exception);
+
+    // Context should still be functional
+    auto result = ctx->eval("2 + 2");
+    EXPECT_EQ(result.toInt32(), 4);
+}
+
+// Validates that serialized bytecode loads into a fresh context
+TEST_F(ScriptTest, SerializeAndLoadBytecode) {
+    auto script = ctx->compile("function square(x) { return x * x; } square(12);", "square.js");
+    std::vector<uint8_t> bytecode = script.serialize();
+    EXPECT_FALSE(bytecode.empty());
+
+    Context other;
+    auto loaded = other.loadScript(bytecode.data(), bytecode.size());
+    EXPECT_EQ(loaded.run().toInt32(), 144);
+    EXPECT_EQ(other.eval("square(3)").toInt32(), 9);
+
+    // Garbage is rejected rather than executed
+    std::vector<uint8_t> garbage(16, 0xff);
+    EXPECT_THROW(other.loadScript(garbage.data(), garbage.size()), Exception);
+}
+
+// Validates that evalFile reuses cached bytecode across contexts and recovers from stale entries
+TEST_F(ScriptTest, BytecodeCacheForEvalFile) {
+    auto dir = makeWorkDir();
+    auto scriptPath = (dir / "bootstrap.js").string();
+    auto cacheDir = (dir / "cache").string();
+    writeFile(scriptPath, "var bootValue = 6 * 7; bootValue;");
+
+    {
+        Context first;
+        first.setBytecodeCacheDirectory(cacheDir);
+        EXPECT_EQ(first.evalFile(scriptPath).toInt32(), 42);
+        EXPECT_EQ(first.getBytecodeCacheStats().misses, 1u);
+        EXPECT_EQ(first.getBytecodeCacheStats().writes, 1u);
+    }
+
+    {
+        Context second;
+        second.setBytecodeCacheDirectory(cacheDir);
+        EXPECT_EQ(second.evalFile(scriptPath).toInt32(), 42);
+        EXPECT_EQ(second.getBytecodeCacheStats().hits, 1u);
+        EXPECT_EQ(second.getBytecodeCacheStats().misses, 0u);
+    }
+
+    // Corrupt every cache entry: loading falls back to source and rewrites it
+    for (const auto& entry : std::filesystem::directory_iterator(cacheDir)) {
+        writeFile(entry.path(), "not bytecode");
+    }
+    {
+        Context third;
+        third.setBytecodeCacheDirectory(cacheDir);
+        EXPECT_EQ(third.evalFile(scriptPath).toInt32(), 42);
+        EXPECT_EQ(third.getBytecodeCacheStats().misses, 1u);
+        EXPECT_EQ(third.evalFile(scriptPath).toInt32(), 42);
+        EXPECT_EQ(third.getBytecodeCacheStats().hits, 1u);
+    }
+
+    // Changed source never reuses the old entry
+    writeFile(scriptPath, "var bootValue = 10; bootValue;");
+    Context fourth;
+    fourth.setBytecodeCacheDirectory(cacheDir);
+    EXPECT_EQ(fourth.evalFile(scriptPath).toInt32(), 10);
+    EXPECT_EQ(fourth.getBytecodeCacheStats().hits, 0u);
+}
+
+// Validates that evalFile without a cache directory still reports missing files
+TEST_F(ScriptTest, EvalFileWithoutCache) {
+    auto dir = makeWorkDir();
+    writeFile(dir / "plain.js", "'plain'");
+    EXPECT_EQ(ctx->evalFile((dir / "plain.js").string()).toString(), "plain");
+    EXPECT_TRUE(ctx->getBytecodeCacheDirectory().empty());
+    EXPECT_THROW(ctx->evalFile((dir / "missing.js").string()), Exception);
+}
+
+// Validates that scripts compiled to bytecode at build time load without the parser
+TEST_F(ScriptTest, EmbeddedBootstrapScripts) {
+    ASSERT_EQ(quickjs_wrapper_test_scripts_count, 2u);
+    EXPECT_STREQ(quickjs_wrapper_test_scripts[0].name, "bootstrap.js");
+    EXPECT_STREQ(quickjs_wrapper_test_scripts[1].name, "routes.js");
+
+    QuickJSWrapper::Value last = ctx->newUndefined();
+    for (size_t i = 0; i < quickjs_wrapper_test_scripts_count; ++i) {
+        last = ctx->evalEmbedded(quickjs_wrapper_test_scripts[i]);
+    }
+    EXPECT_EQ(last.toInt32(), 1);
+
+    EXPECT_EQ(ctx->eval("bootstrap.version").toInt32(), 3);
+    EXPECT_EQ(ctx->eval("routes['/greet']('world')").toString(), "hello, world");
+
+    // A fresh context starts from the same embedded bytecode
+    Context other;
+    other.evalEmbedded(quickjs_wrapper_test_scripts[0]);
+    EXPECT_EQ(other.eval("bootstrap.greet('again')").toString(), "hello, again");
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_snapshot.h"
+#include <algorithm>
+#include <memory>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating context snapshots captured after an init script
+class SnapshotTest : public Test {
+protected:
+    static constexpr const char* kDataInit = R"(
+        var table = {};
+        for (var i = 0; i < 100; i++) {
+            table['key' + i] = { index: i, label: 'entry_' + i };
+        }
+        var alias = table;
+        var settings = { retries: 3, hosts: ['a', 'b'] };
+    )";
+};
+
+// Validates that data-only globals are restored by deserialization alone
+TEST_F(SnapshotTest, DataGlobalsRestoredWithoutReplay) {
+    auto snapshot = ContextSnapshot::capture(kDataInit, "data_init.js");
+    EXPECT_FALSE(snapshot.requiresReplay());
+
+    auto captured = snapshot.getCapturedGlobals();
+    std::sort(captured.begin(), captured.end());
+    EXPECT_THAT(captured, ElementsAre("alias", "i", "settings", "table"));
+
+    auto ctx = snapshot.instantiate();
+    EXPECT_EQ(ctx->eval("table.key42.label").toString(), "entry_42");
+    EXPECT_EQ(ctx->eval("settings.hosts.length").toInt32(), 2);
+
+    // References shared between globals survive the round trip
+    EXPECT_TRUE(ctx->eval("alias === table").toBool());
+}
+
+// Validates that function globals force a replay of the precompiled init script
+TEST_F(SnapshotTest, FunctionGlobalsFallBackToReplay) {
+    auto snapshot = ContextSnapshot::capture(R"(
+        var prefix = 'id-';
+        function makeId(n) { return prefix + n; }
+    )");
+    EXPECT_TRUE(snapshot.requiresReplay());
+    EXPECT_THAT(snapshot.getUnserializableGlobals(), ElementsAre("makeId"));
+
+    auto ctx = snapshot.instantiate();
+    EXPECT_EQ(ctx->eval("makeId(7)").toString(), "id-7");
+}
+
+// Validates that materialized contexts are independent of each other
+TEST_F(SnapshotTest, InstancesAreIndependent) {
+    auto snapshot = ContextSnapshot::capture(kDataInit);
+    auto runtime = std::make_shared<Runtime>();
+
+    auto first = snapshot.instantiate(runtime);
+    auto second = snapshot.instantiate(runtime);
+    first->eval("settings.retries = 10; table.key1 = null;");
+
+    EXPECT_EQ(second->eval("settings.retries").toInt32(), 3);
+    EXPECT_EQ(second->eval("table.key1.index").toInt32(), 1);
+    EXPECT_EQ(first->eval("settings.retries").toInt32(), 10);
+}
+
+// Validates that init script errors are reported at capture time
+TEST_F(SnapshotTest, CaptureReportsInitErrors) {
+    EXPECT_THROW(ContextSnapshot::capture("var broken = ;"), Exception);
+    EXPECT_THROW(ContextSnapshot::capture("undefinedFunction();"), Exception);
+}
+
+// Validates that state outside the global object's properties forces a replay
+TEST_F(SnapshotTest, HiddenStateFallsBackToReplay) {
+    auto lexical = ContextSnapshot::capture(R"(
+        var visible = 1;
+        let counter = 5;
+        const limit = 10;
+        class Registry {}
+    )");
+    EXPECT_TRUE(lexical.requiresReplay());
+    EXPECT_THAT(lexical.getReplayReasons(), UnorderedElementsAre(
+        "top-level lexical binding: Registry", "top-level lexical binding: counter",
+        "top-level lexical binding: limit"));
+    auto restored = lexical.instantiate();
+    EXPECT_EQ(restored->eval("counter + limit + visible").toInt32(), 16);
+    EXPECT_EQ(restored->eval("typeof Registry").toString(), "function");
+
+    auto polyfill = ContextSnapshot::capture(R"(
+        Array.prototype.last = function () { return this[this.length - 1]; };
+        var data = [1, 2, 3];
+    )");
+    EXPECT_THAT(polyfill.getReplayReasons(), ElementsAre("built-in objects were modified"));
+    EXPECT_EQ(polyfill.instantiate()->eval("data.last()").toInt32(), 3);
+
+    auto overwritten = ContextSnapshot::capture("JSON.stringify = null; var ok = true;");
+    EXPECT_TRUE(overwritten.requiresReplay());
+    EXPECT_TRUE(overwritten.instantiate()->eval("JSON.stringify === null").toBool());
+
+    auto evaluated = ContextSnapshot::capture("(0, eval)('let hidden = 1');");
+    EXPECT_THAT(evaluated.getReplayReasons(), Contains("the script calls eval"));
+}
+
+// Validates that data the serializer would not reproduce forces a replay
+TEST_F(SnapshotTest, LossyDataFallsBackToReplay) {
+    auto lossy = ContextSnapshot::capture(R"(
+        var derived = Object.create({ kind: 'base' });
+        var frozen = Object.freeze({ a: 1 });
+        var hidden = {};
+        Object.defineProperty(hidden, 'secret', { value: 1 });
+        var tagged = { nested: {} };
+        tagged.nested[Symbol.for('tag')] = 1;
+        var sparse = [1, , 3];
+        var sized = new Uint8Array(4);
+    )");
+    EXPECT_THAT(lossy.getReplayReasons(), UnorderedElementsAre(
+        "global would lose state when serialized: derived is not a plain object or array",
+        "global would lose state when serialized: frozen is frozen, sealed or not extensible",
+        "global would lose state when serialized: hidden.secret is not writable, enumerable and configurable",
+        "global would lose state when serialized: tagged.nested has a symbol-keyed property",
+        "global would lose state when serialized: sparse is sparse or has named properties",
+        "global would lose state when serialized: sized is not a plain object or array"));
+
+    auto ctx = lossy.instantiate();
+    EXPECT_EQ(ctx->eval("derived.kind").toString(), "base");
+    EXPECT_TRUE(ctx->eval("Object.isFrozen(frozen)").toBool());
+    EXPECT_EQ(ctx->eval("hidden.secret").toInt32(), 1);
+    EXPECT_EQ(ctx->eval("tagged.nested[Symbol.for('tag')]").toInt32(), 1);
+}
+
+// Validates that capture reads descriptors instead of running getters, and
+// that restored globals keep their attributes
+TEST_F(SnapshotTest, GlobalsKeepTheirAttributes) {
+    auto accessor = ContextSnapshot::capture(R"(
+        Object.defineProperty(globalThis, 'lazy', {
+            get: function () { throw new Error('getter ran during capture'); },
+            configurable: true
+        });
+    )");
+    EXPECT_THAT(accessor.getReplayReasons(), ElementsAre("global is an accessor property: lazy"));
+
+    auto assigned = ContextSnapshot::capture(R"(
+        var declared = 1;
+        globalThis.assigned = { value: 2 };
+    )");
+    ASSERT_FALSE(assigned.requiresReplay());
+    auto ctx = assigned.instantiate();
+    EXPECT_FALSE(ctx->eval("Object.getOwnPropertyDescriptor(globalThis, 'declared').configurable").toBool());
+    EXPECT_TRUE(ctx->eval("Object.getOwnPropertyDescriptor(globalThis, 'assigned').configurable").toBool());
+    EXPECT_TRUE(ctx->eval("delete globalThis.assigned").toBool());
+}
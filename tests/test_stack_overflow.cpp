@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "quickjs_wrapper.h"
+#include "quickjs_event_loop.h"
 #include <chrono>
 #include <thread>
 
@@ -272,34 +273,26 @@ TEST_F(StackOverflowTest, RecursiveGenerators) {
 
 // QuickJS Promise 체인 안전성 테스트
 TEST_F(StackOverflowTest, PromiseChainSafetyValidation) {
-    // This test might not work depending on QuickJS Promise support
-    try {
-        ctx->eval(R"(
-            function recursivePromise(depth) {
-                if (depth > 5000) {
-                    return Promise.resolve(depth);
-                }
-                
-                return Promise.resolve().then(function() {
-                    return recursivePromise(depth + 1);
-                });
+    EventLoop loop(*ctx);
+    ctx->eval(R"(
+        function recursivePromise(depth) {
+            if (depth > 5000) {
+                return Promise.resolve(depth);
             }
-        )");
-        
-        // Test should pass whether it throws, completes, or returns a promise
-        try {
-            auto result = ctx->eval("recursivePromise(0)");
-            // Promise operations might not cause immediate stack overflow
-            SUCCEED() << "QuickJS safely processed promise chain";
-        } catch (const Exception& e) {
-            // If it throws due to stack overflow, that's also good
-            SUCCEED() << "QuickJS safely handled promise chain overflow: " << e.what();
+            
+            return Promise.resolve().then(function() {
+                return recursivePromise(depth + 1);
+            });
         }
-        
-    } catch (const Exception& e) {
-        // If Promise is not supported, that's fine
-        GTEST_SKIP() << "Promises not supported in this QuickJS build: " << e.what();
-    }
+    )");
+    
+    // Each step runs as a separate job, so draining the queue completes the chain
+    ctx->eval("var settled = null; recursivePromise(0).then(function(v) { settled = v; });");
+    EXPECT_TRUE(ctx->eval("settled === null").toBool());
+    
+    loop.run();
+    EXPECT_FALSE(loop.hasPendingJobs());
+    EXPECT_EQ(ctx->eval("settled").toInt32(), 5001);
 }
 
 // Test stack overflow detection and recovery
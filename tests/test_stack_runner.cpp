@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_stack.h"
+#include <memory>
+#include <stdexcept>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+namespace {
+    // Deepest recursion reached before the stack limit throws
+    const char* kProbeDepth = R"(
+        (function () {
+            var depth = 0;
+            function descend() { depth++; descend(); }
+            try { descend(); } catch (e) {}
+            return depth;
+        })()
+    )";
+
+    const char* kRecursion = "function nest(n) { return n === 0 ? 0 : 1 + nest(n - 1); }";
+}
+
+// Tests validating configurable stack limits and large-stack evaluation
+class StackRunnerTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+        ctx->eval(kRecursion);
+    }
+
+    void TearDown() override {
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+};
+
+// Validates that the configured stack limit bounds recursion depth
+TEST_F(StackRunnerTest, MaxStackSizeOption) {
+    EXPECT_EQ(ctx->getMaxStackSize(), Runtime::kDefaultMaxStackSize);
+    int defaultDepth = ctx->eval(kProbeDepth).toInt32();
+
+    RuntimeOptions options;
+    options.maxStackSize = Runtime::kDefaultMaxStackSize / 4;
+    Context small(options);
+    EXPECT_EQ(small.getMaxStackSize(), options.maxStackSize);
+    int smallDepth = small.eval(kProbeDepth).toInt32();
+
+    EXPECT_GT(smallDepth, 10);
+    EXPECT_LT(smallDepth, defaultDepth);
+    std::cout << "Recursion depth with " << options.maxStackSize << " byte limit: " << smallDepth
+              << ", default: " << defaultDepth << std::endl;
+}
+
+// Validates that a large-stack runner allows recursion far past the default limit
+TEST_F(StackRunnerTest, DeepRecursionOnLargeStack) {
+    int defaultDepth = ctx->eval(kProbeDepth).toInt32();
+    int target = defaultDepth * 8;
+    EXPECT_THROW(ctx->eval("nest(" + std::to_string(target) + ")"), Exception);
+
+    StackRunner runner(256 * 1024 * 1024);
+    auto result = runner.eval(*ctx, "nest(" + std::to_string(target) + ")");
+    EXPECT_EQ(result.toInt32(), target);
+
+    // The calling thread is back on the configured limit
+    EXPECT_EQ(ctx->getMaxStackSize(), Runtime::kDefaultMaxStackSize);
+    EXPECT_THROW(ctx->eval("nest(" + std::to_string(target) + ")"), Exception);
+    EXPECT_EQ(ctx->eval("nest(10)").toInt32(), 10);
+}
+
+// Validates that peak native stack usage is reported per run
+TEST_F(StackRunnerTest, ReportsPeakStackUsage) {
+    StackRunner runner(64 * 1024 * 1024);
+
+    runner.eval(*ctx, "nest(10)");
+    size_t shallow = runner.getLastPeakUsage();
+    runner.eval(*ctx, "nest(20000)");
+    size_t deep = runner.getLastPeakUsage();
+    runner.eval(*ctx, "nest(10)");
+
+    EXPECT_GT(shallow, 0u);
+    EXPECT_GT(deep, shallow * 4);
+    EXPECT_LE(deep, runner.getStackSize());
+    EXPECT_EQ(runner.getMaxPeakUsage(), deep);
+    // Released pages do not inflate later measurements
+    EXPECT_LT(runner.getLastPeakUsage(), deep);
+
+    std::cout << "Peak native stack: " << shallow << " bytes for depth 10, "
+              << deep << " bytes for depth 20000" << std::endl;
+}
+
+// Validates that results and exceptions cross back to the calling thread
+TEST_F(StackRunnerTest, RunPropagatesResultsAndErrors) {
+    StackRunner runner(8 * 1024 * 1024);
+
+    int doubled = runner.run(*ctx, [&]() { return ctx->eval("21 * 2").toInt32(); });
+    EXPECT_EQ(doubled, 42);
+
+    EXPECT_THROW(runner.eval(*ctx, "throw new Error('on the runner')"), Exception);
+    EXPECT_THROW(runner.run(*ctx, []() { throw std::runtime_error("native"); }), std::runtime_error);
+
+    // Stack overflow on the runner is still a catchable JS error
+    EXPECT_THROW(runner.eval(*ctx, "(function f() { return f() + 1; })()"), Exception);
+    EXPECT_EQ(ctx->eval("'still usable'").toString(), "still usable");
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include <memory>
+#include <string>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating the per-context interned string cache
+class StringCacheTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+    }
+
+    void TearDown() override {
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+};
+
+// Validates that repeated content shares one JS string
+TEST_F(StringCacheTest, RepeatedContentShared) {
+    auto first = ctx->newCachedString("status");
+    auto second = ctx->newCachedString(std::string("status"));
+    EXPECT_EQ(JS_VALUE_GET_PTR(first.getJSValue()), JS_VALUE_GET_PTR(second.getJSValue()));
+    EXPECT_EQ(second.toString(), "status");
+
+    std::string withNul("a\0b", 3);
+    EXPECT_EQ(ctx->newCachedString(withNul).toString(), withNul);
+    EXPECT_NE(JS_VALUE_GET_PTR(ctx->newCachedString("a").getJSValue()),
+              JS_VALUE_GET_PTR(ctx->newCachedString(withNul).getJSValue()));
+
+    auto stats = ctx->getStringCacheStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.entries, 3u);
+    EXPECT_EQ(stats.capacity, Context::kDefaultStringCacheCapacity);
+}
+
+// Validates least-recently-used eviction at the capacity bound
+TEST_F(StringCacheTest, EvictsLeastRecentlyUsed) {
+    ctx->setStringCacheCapacity(2);
+    ctx->newCachedString("a");
+    ctx->newCachedString("b");
+    ctx->newCachedString("a");
+    ctx->newCachedString("c");
+
+    auto stats = ctx->getStringCacheStats();
+    EXPECT_EQ(stats.entries, 2u);
+    EXPECT_EQ(stats.evictions, 1u);
+
+    ctx->newCachedString("a");
+    EXPECT_EQ(ctx->getStringCacheStats().hits, 2u);
+    ctx->newCachedString("b");
+    EXPECT_EQ(ctx->getStringCacheStats().misses, 4u);
+
+    ctx->setStringCacheCapacity(1);
+    EXPECT_EQ(ctx->getStringCacheStats().entries, 1u);
+}
+
+// Validates disabling and clearing the cache
+TEST_F(StringCacheTest, DisableAndClear) {
+    ctx->runGC();
+    size_t baseline = ctx->getMemoryUsage();
+    for (int i = 0; i < 2000; ++i) {
+        ctx->newCachedString(std::string(512, 'k') + std::to_string(i));
+    }
+    EXPECT_EQ(ctx->getStringCacheStats().entries, Context::kDefaultStringCacheCapacity);
+
+    ctx->clearStringCache();
+    ctx->runGC();
+    EXPECT_EQ(ctx->getStringCacheStats().entries, 0u);
+    EXPECT_LT(ctx->getMemoryUsage(), baseline + 64 * 1024);
+
+    ctx->setStringCacheCapacity(0);
+    auto first = ctx->newCachedString("plain");
+    auto second = ctx->newCachedString("plain");
+    EXPECT_EQ(second.toString(), "plain");
+    EXPECT_EQ(ctx->getStringCacheStats().entries, 0u);
+    EXPECT_EQ(ctx->getStringCacheStats().hits, 0u);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating copy-free string access and length-based creation
+class StringViewTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+    }
+
+    void TearDown() override {
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+};
+
+// Validates reading strings and converted values through a view
+TEST_F(StringViewTest, ReadsWithoutCopy) {
+    auto greeting = ctx->eval("'hello, ' + 'world'");
+    StringView view = greeting.toStringView();
+    EXPECT_EQ(view.view(), "hello, world");
+    EXPECT_EQ(view.size(), 12u);
+    EXPECT_EQ(view.data()[view.size()], '\0');
+
+    std::string_view implicit = view;
+    EXPECT_EQ(implicit.substr(7), "world");
+
+    EXPECT_EQ(ctx->newNumber(1.5).toStringView().view(), "1.5");
+    EXPECT_EQ(greeting.ref().toStringView().view(), "hello, world");
+    EXPECT_EQ(ctx->eval("'été'").toStringView().view(), "\xc3\xa9t\xc3\xa9");
+    EXPECT_TRUE(ctx->newString("").toStringView().empty());
+    EXPECT_THROW(ctx->eval("Symbol('s')").toStringView(), Exception);
+}
+
+// Validates that moving a view transfers the C string
+TEST_F(StringViewTest, MoveOnly) {
+    StringView first = ctx->newString("first").toStringView();
+    const char* data = first.data();
+
+    StringView second(std::move(first));
+    EXPECT_EQ(second.data(), data);
+    EXPECT_EQ(first.data(), nullptr);
+    EXPECT_TRUE(first.empty());
+
+    first = ctx->newString("again").toStringView();
+    second = std::move(first);
+    EXPECT_EQ(second.view(), "again");
+}
+
+// Validates embedded NULs and buffers without a terminator
+TEST_F(StringViewTest, LengthBasedStrings) {
+    std::string withNul("key\0value", 9);
+    auto value = ctx->newString(withNul);
+    ctx->setGlobalProperty("withNul", value);
+    EXPECT_EQ(ctx->eval("withNul.length").toInt32(), 9);
+    EXPECT_EQ(ctx->eval("withNul.charCodeAt(3)").toInt32(), 0);
+    EXPECT_EQ(value.toStringView().view(), std::string_view(withNul));
+    EXPECT_EQ(value.toString(), withNul);
+
+    const char buffer[] = {'a', 'b', 'c', 'd'};
+    EXPECT_EQ(ctx->newString(buffer, 3).toString(), "abc");
+    EXPECT_EQ(ctx->newString(std::string_view(buffer + 1, 2)).toString(), "bc");
+    EXPECT_EQ(ctx->newString("literal").toString(), "literal");
+}
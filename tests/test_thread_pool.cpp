@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_thread_pool.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+namespace {
+    // Occupies a worker until released
+    struct Gate {
+        std::promise<void> started;
+        std::promise<void> open;
+        std::shared_future<void> opened = open.get_future().share();
+
+        std::function<void()> task() {
+            return [this]() {
+                started.set_value();
+                opened.wait();
+            };
+        }
+    };
+}
+
+// Tests validating the bounded worker pool and asynchronous native functions
+class ThreadPoolTest : public Test {
+};
+
+// Validates that tasks run, failures are counted and the queue drains on destruction
+TEST_F(ThreadPoolTest, RunsTasksAndCountsFailures) {
+    std::atomic<int> ran{0};
+    {
+        ThreadPool pool(ThreadPoolOptions{4, 0});
+        EXPECT_EQ(pool.size(), 4u);
+        for (int i = 0; i < 200; ++i) {
+            pool.submit([&ran, i]() {
+                ran++;
+                if (i % 10 == 0) {
+                    throw Exception("task failed");
+                }
+            });
+        }
+        while (pool.getMetrics().completed < 200) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto metrics = pool.getMetrics();
+        EXPECT_EQ(metrics.submitted, 200u);
+        EXPECT_EQ(metrics.failed, 20u);
+        EXPECT_EQ(metrics.active, 0u);
+
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&ran]() { ran++; });
+        }
+    }
+    EXPECT_EQ(ran.load(), 300);
+}
+
+// Validates the queue bound, rejection counting and blocking submission
+TEST_F(ThreadPoolTest, BoundedQueueBackpressure) {
+    ThreadPool pool(ThreadPoolOptions{1, 2});
+    Gate gate;
+    ASSERT_TRUE(pool.trySubmit(gate.task()));
+    gate.started.get_future().wait();
+
+    EXPECT_TRUE(pool.trySubmit([]() {}));
+    EXPECT_TRUE(pool.trySubmit([]() {}));
+    EXPECT_FALSE(pool.trySubmit([]() {}));
+    EXPECT_EQ(pool.queueDepth(), 2u);
+
+    // A blocking submit waits for the worker to make room
+    std::atomic<bool> queued{false};
+    std::thread producer([&]() {
+        pool.submit([]() {});
+        queued = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(queued);
+
+    gate.open.set_value();
+    producer.join();
+    EXPECT_TRUE(queued);
+
+    auto metrics = pool.getMetrics();
+    EXPECT_EQ(metrics.rejected, 1u);
+    EXPECT_EQ(metrics.peakQueueDepth, 2u);
+    EXPECT_GT(metrics.maxQueueWait.count(), 0);
+}
+
+// Validates that asynchronous bindings run on the pool and overlap
+TEST_F(ThreadPoolTest, AsyncBindingOverlapsCalls) {
+    ThreadPool pool(ThreadPoolOptions{8, 64});
+    Context ctx;
+    EventLoop loop(ctx);
+    auto jsThread = std::this_thread::get_id();
+    std::atomic<int> onJsThread{0};
+
+    bindAsyncGlobalFunction(loop, pool, "lookup", [&](std::string_view key, int32_t index) {
+        if (std::this_thread::get_id() == jsThread) {
+            onJsThread++;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return std::string(key) + std::to_string(index);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    auto joined = loop.await(ctx.eval(R"(
+        var calls = [];
+        for (var i = 0; i < 16; i++) {
+            calls.push(lookup('key', i));
+        }
+        Promise.all(calls).then(function (values) { return values.join(','); });
+    )"));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_THAT(joined.toString(), StartsWith("key0,key1,key2"));
+    EXPECT_THAT(joined.toString(), EndsWith("key15"));
+    EXPECT_EQ(onJsThread.load(), 0);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(16 * 20));
+    EXPECT_EQ(pool.getMetrics().submitted, 16u);
+}
+
+// Validates that thrown errors and a full queue reject the returned promise
+TEST_F(ThreadPoolTest, AsyncBindingRejections) {
+    ThreadPool pool(ThreadPoolOptions{1, 1});
+    Context ctx;
+    EventLoop loop(ctx);
+
+    bindAsyncGlobalFunction(loop, pool, "load", [](int32_t id) -> int32_t {
+        if (id < 0) {
+            throw Exception("no such record");
+        }
+        return id * 10;
+    });
+
+    try {
+        loop.await(ctx.eval("load(-1)"));
+        FAIL() << "rejection should throw";
+    } catch (const Exception& e) {
+        EXPECT_THAT(e.what(), HasSubstr("no such record"));
+    }
+
+    Gate gate;
+    ASSERT_TRUE(pool.trySubmit(gate.task()));
+    gate.started.get_future().wait();
+
+    ctx.eval(R"(
+        var results = [];
+        load(1).then(function (v) { results.push(v); });
+        load(2).catch(function (e) { results.push(e.message); });
+    )");
+    gate.open.set_value();
+    loop.run();
+
+    EXPECT_EQ(ctx.eval("results.join('|')").toString(),
+              "Failed to schedule load: worker queue is full|10");
+    EXPECT_EQ(pool.getMetrics().rejected, 1u);
+
+    // Arguments that cannot be converted fail synchronously
+    EXPECT_THROW(ctx.eval("load(Symbol('x'))"), Exception);
+}
+
+// Validates that a binding called after its loop or pool is gone throws
+// instead of touching freed objects
+TEST_F(ThreadPoolTest, AsyncBindingAfterTeardown) {
+    Context ctx;
+    auto pool = std::make_unique<ThreadPool>(ThreadPoolOptions{1, 0});
+    auto loop = std::make_unique<EventLoop>(ctx);
+    bindAsyncGlobalFunction(*loop, *pool, "load", [](int32_t id) { return id; });
+
+    pool.reset();
+    try {
+        ctx.eval("load(1)");
+        FAIL() << "call after pool teardown should throw";
+    } catch (const Exception& e) {
+        EXPECT_THAT(e.what(), HasSubstr("Thread pool has been destroyed"));
+    }
+
+    loop.reset();
+    try {
+        ctx.eval("load(1)");
+        FAIL() << "call after loop teardown should throw";
+    } catch (const Exception& e) {
+        EXPECT_THAT(e.what(), HasSubstr("Event loop has been destroyed"));
+    }
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "quickjs_wrapper.h"
+#include <memory>
+#include <string>
+
+using namespace QuickJSWrapper;
+using namespace testing;
+
+// Tests validating borrowed values and reference ownership
+class ValueRefTest : public Test {
+protected:
+    void SetUp() override {
+        ctx = std::make_unique<Context>();
+    }
+
+    void TearDown() override {
+        ctx.reset();
+    }
+
+    std::unique_ptr<Context> ctx;
+};
+
+// Validates reads, calls and promotion through a borrowed value
+TEST_F(ValueRefTest, BorrowedAccess) {
+    auto object = ctx->eval("({ name: 'widget', sizes: [3, 5, 8], scale: function (x) { return x * this.factor; }, factor: 4 })");
+    ValueRef ref = object;
+
+    EXPECT_TRUE(ref.isObject());
+    EXPECT_EQ(ref.getProperty("name").toString(), "widget");
+    auto sizes = ref.getProperty("sizes");
+    EXPECT_EQ(ValueRef(sizes).getArrayLength(), 3u);
+    EXPECT_EQ(ValueRef(sizes).getElement(2).toInt32(), 8);
+
+    auto number = ctx->newInt32(5);
+    EXPECT_EQ(ref.callMethod(ctx->newPropertyKey("scale"), {number}).toInt32(), 20);
+    auto parse = ctx->eval("parseInt");
+    EXPECT_EQ(parse.ref().call({ctx->newString("42")}).toInt32(), 42);
+
+    // toValue takes a reference of its own
+    QuickJSWrapper::Value kept = ref.toValue();
+    object = ctx->newUndefined();
+    ctx->runGC();
+    EXPECT_EQ(kept.getProperty("factor").toInt32(), 4);
+}
+
+// Validates that typed bindings can take arguments without owning them
+TEST_F(ValueRefTest, TypedBindingWithBorrowedArguments) {
+    ctx->bindGlobalFunction("describe", [](ValueRef value, ValueRef key) {
+        return value.getProperty(key.toString()).toString();
+    });
+    ctx->bindGlobalFunction("identity", [](ValueRef value) { return value; });
+
+    EXPECT_EQ(ctx->eval("describe({ a: 'first' }, 'a')").toString(), "first");
+    EXPECT_TRUE(ctx->eval("var o = {}; identity(o) === o").toBool());
+}
+
+// Validates that created and fetched values release their references
+TEST_F(ValueRefTest, CreatedValuesDoNotLeak) {
+    ctx->eval("var holder = { item: { payload: 'x'.repeat(256) } };");
+    ctx->runGC();
+    size_t baseline = ctx->getMemoryUsage();
+
+    for (int i = 0; i < 20000; ++i) {
+        ctx->newString(std::string(256, 'a') + std::to_string(i));
+        ctx->newObject();
+        ctx->newArray();
+        ctx->eval("({ index: " + std::to_string(i) + " })");
+        ctx->getGlobalProperty("holder").getProperty("item");
+        ctx->getGlobal();
+    }
+    ctx->runGC();
+
+    EXPECT_LT(ctx->getMemoryUsage(), baseline + 256 * 1024);
+}
+
+// Validates adopt-versus-dup construction against the object's reference count
+TEST_F(ValueRefTest, AdoptAndDup) {
+    auto refCount = [](const QuickJSWrapper::Value& value) {
+        return static_cast<JSRefCountHeader*>(JS_VALUE_GET_PTR(value.getJSValue()))->ref_count;
+    };
+    JSContext* jsCtx = ctx->getJSContext();
+    JSValue raw = JS_NewObject(jsCtx);
+
+    QuickJSWrapper::Value shared = QuickJSWrapper::Value::dup(jsCtx, raw);
+    EXPECT_EQ(refCount(shared), 2);
+    QuickJSWrapper::Value adopted = QuickJSWrapper::Value::adopt(jsCtx, raw);
+    EXPECT_EQ(refCount(shared), 2);
+
+    ValueRef borrowed = adopted;
+    ValueRef another = borrowed;
+    EXPECT_TRUE(another.isObject());
+    EXPECT_EQ(refCount(shared), 2);
+
+    QuickJSWrapper::Value copy = shared;
+    EXPECT_EQ(refCount(shared), 3);
+    copy = ctx->newUndefined();
+    adopted = ctx->newUndefined();
+    EXPECT_EQ(refCount(shared), 1);
+}
+
+#ifdef QUICKJS_WRAPPER_REFCOUNT_STATS
+// Validates the reference count traffic of copies versus borrows
+TEST_F(ValueRefTest, RefcountTraffic) {
+    auto object = ctx->newObject();
+
+    resetRefcountStats();
+    ValueRef first = object;
+    ValueRef second = first;
+    EXPECT_TRUE(second.isObject());
+    EXPECT_EQ(getRefcountStats().dups, 0u);
+    EXPECT_EQ(getRefcountStats().frees, 0u);
+
+    {
+        QuickJSWrapper::Value copy = object;
+        EXPECT_TRUE(copy.isObject());
+    }
+    EXPECT_EQ(getRefcountStats().dups, 1u);
+    EXPECT_EQ(getRefcountStats().frees, 1u);
+
+    // Fresh values are adopted, so creating one costs a single free
+    resetRefcountStats();
+    ctx->newObject();
+    EXPECT_EQ(getRefcountStats().dups, 0u);
+    EXPECT_EQ(getRefcountStats().frees, 1u);
+}
+#endif
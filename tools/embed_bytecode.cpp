@@ -0,0 +1,116 @@
+// Compiles JavaScript sources to QuickJS bytecode and emits them as C++ arrays.
+//
+// Usage: quickjs_embed_bytecode <output.cpp> <output.h> <symbol> <input.js>...
+//
+// The generated header declares
+//     extern const QuickJSWrapper::EmbeddedScript <symbol>[];
+//     extern const size_t <symbol>_count;
+// which Context::evalEmbedded loads without touching the parser or filesystem.
+
+#include "quickjs_wrapper.h"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace QuickJSWrapper;
+
+namespace {
+    std::string readSource(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw Exception("Failed to open file: " + path);
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    void writeArray(std::ostream& out, const std::string& name, const std::vector<uint8_t>& bytes) {
+        out << "const uint8_t " << name << "[] = {";
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            if (i % 16 == 0) {
+                out << "\n    ";
+            }
+            out << "0x" << std::hex << std::setw(2) << std::setfill('0')
+                << static_cast<int>(bytes[i]) << std::dec << ",";
+        }
+        out << "\n};\n\n";
+    }
+
+    // Contents of a C++ string literal spelling 'text'
+    std::string escapeLiteral(const std::string& text) {
+        std::ostringstream out;
+        for (unsigned char c : text) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (c < 0x20 || c == 0x7f) {
+                // Three octal digits, so a following digit cannot extend the escape
+                out << '\\' << std::oct << std::setw(3) << std::setfill('0')
+                    << static_cast<int>(c) << std::dec;
+            } else {
+                out << c;
+            }
+        }
+        return out.str();
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " <output.cpp> <output.h> <symbol> <input.js>..." << std::endl;
+        return 1;
+    }
+    
+    const std::string outputSource = argv[1];
+    const std::string outputHeader = argv[2];
+    const std::string symbol = argv[3];
+    
+    try {
+        Context ctx;
+        std::vector<std::string> names;
+        std::vector<std::vector<uint8_t>> bytecodes;
+        for (int i = 4; i < argc; ++i) {
+            std::string path = argv[i];
+            std::string name = std::filesystem::path(path).filename().string();
+            Script script = ctx.compile(readSource(path), name);
+            names.push_back(name);
+            bytecodes.push_back(script.serialize());
+        }
+        
+        std::ofstream header(outputHeader, std::ios::trunc);
+        header << "// Generated by quickjs_embed_bytecode. Do not edit.\n"
+               << "#pragma once\n\n"
+               << "#include \"quickjs_wrapper.h\"\n\n"
+               << "extern const QuickJSWrapper::EmbeddedScript " << symbol << "[];\n"
+               << "extern const size_t " << symbol << "_count;\n";
+        
+        std::ofstream source(outputSource, std::ios::trunc);
+        source << "// Generated by quickjs_embed_bytecode. Do not edit.\n"
+               << "#include \"" << std::filesystem::path(outputHeader).filename().string() << "\"\n\n"
+               << "namespace {\n\n";
+        for (size_t i = 0; i < bytecodes.size(); ++i) {
+            writeArray(source, "bytecode" + std::to_string(i), bytecodes[i]);
+        }
+        source << "} // namespace\n\n"
+               << "const QuickJSWrapper::EmbeddedScript " << symbol << "[] = {\n";
+        for (size_t i = 0; i < names.size(); ++i) {
+            source << "    {\"" << escapeLiteral(names[i]) << "\", bytecode" << i << ", sizeof(bytecode" << i << ")},\n";
+        }
+        source << "};\n\n"
+               << "const size_t " << symbol << "_count = " << names.size() << ";\n";
+        
+        if (!header || !source) {
+            std::cerr << "Failed to write generated files" << std::endl;
+            return 1;
+        }
+    } catch (const Exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}